@@ -0,0 +1,313 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   uss_benchmark.cpp
+ *   @brief  Benchmark of the USS bus cycle against emulated G110 slaves on a pseudo terminal. Runs send() and
+ *           receive() for every combination of baudrate and number of slaves and writes one JSON object per
+ *           run to stdout: telegrams per second, cycle time percentiles, jitter histogram, PKW job latency
+ *           and CPU time per cycle. Compare the output of two builds to catch timing regressions. -t runs the
+ *           bus with adaptive timing at the given latency percentile and margin instead of the spec timing.
+ *
+ *           usage: uss_benchmark [-b baud,baud,...] [-n slaves,slaves,...] [-c cycles_per_slave] [-d delay_us]
+ *                                [-t percentile,margin_us]
+ *   @date   17.10.2026
+ */
+#include <Emulator/G110Emulator.h>
+#include <USSTransport.h>
+#include <stdio.h>
+
+#define BENCH_MAX_RUNS             16
+#define BENCH_CYCLES_PER_SLAVE     10
+
+/**
+ * @brief Upper bounds of the jitter histogram buckets in us, the last bucket counts everything above
+ */
+static const long jitterBuckets[] = {10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000};
+
+#define BENCH_JITTER_BUCKETS       (int)(sizeof(jitterBuckets) / sizeof(jitterBuckets[0]))
+
+/**
+ * @struct one running parameter read job per slave, queued again when it is finished
+ */
+typedef struct
+{
+    USS *bus;
+    int slaveIndex;
+    struct timespec queued;
+    long *latencies;            // shared by all slaves of the run, in us
+    int *nrLatencies;
+    int maxLatencies;
+    int *errors;
+} benchPkw_t;
+
+static int compareLong(const void *a, const void *b)
+{
+    const long x = *static_cast<const long *>(a);
+    const long y = *static_cast<const long *>(b);
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Percentile of sorted samples, nearest rank
+ */
+static long percentile(const long sorted[], const int n, const double p)
+{
+    int rank;
+
+    if(n == 0)
+        return 0;
+
+    rank = (int)(p / 100.0 * n + 0.5);
+
+    if(rank < 1)
+        rank = 1;
+    if(rank > n)
+        rank = n;
+
+    return sorted[rank - 1];
+}
+
+static int parseList(char *arg, int list[], const int max)
+{
+    int n = 0;
+
+    for(char *value = strtok(arg, ","); value != nullptr && n < max; value = strtok(nullptr, ","))
+        list[n++] = atoi(value);
+
+    return n;
+}
+
+static void pkwCallback(const int result, const uint16_t param, const uint32_t value, void *context)
+{
+    benchPkw_t *pkw = static_cast<benchPkw_t *>(context);
+    struct timespec now;
+
+    (void)value;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    if(result != 0)
+        (*pkw->errors)++;
+    else if(*pkw->nrLatencies < pkw->maxLatencies)
+        pkw->latencies[(*pkw->nrLatencies)++] = ussTimespecDiffNs(now, pkw->queued) / NSEC_PER_USEC;
+
+    // called from receive() in the benchmark thread, so the next job is queued for the next telegram
+    pkw->queued = now;
+    pkw->bus->getParameterAsync(param, pkw->slaveIndex, 0, pkwCallback, pkw);
+}
+
+/**
+ * @brief Run the bus cycle for one baudrate and number of slaves and print the results as JSON
+ */
+static int runBenchmark(const unsigned int speed, const int nrSlaves, const int cycles, const int respDelayUs,
+                        const int paramLag, const ussTimingConfig_t &timing)
+{
+    G110Emulator *emulator = new G110Emulator();
+    USS *bus = new USS();
+    USSTermiosTransport transport;
+    g110EmulatorConfig_t config = {speed, respDelayUs, 0, 0, 1, paramLag};
+    ussCycleStats_t stats;
+    benchPkw_t pkw[USS_SLAVES];
+    char slaves[USS_SLAVES];
+    long *periods = new long[cycles];
+    long *jitters = new long[cycles];
+    long *cpu = new long[cycles];
+    long *latencies = new long[cycles];
+    long jitterHist[BENCH_JITTER_BUCKETS + 1] = {0};
+    int nrLatencies = 0;
+    int pkwErrors = 0;
+    int nrPeriods = 0;
+    int timeouts = 0;
+    long long cpuSum = 0;
+    struct timespec start, end, cpuStart, cpuEnd;
+    int ret = -1;
+
+    for(int i = 0; i < nrSlaves; i++)
+        slaves[i] = i + 1;
+
+    if(emulator->begin(slaves, nrSlaves, config) != 0 || emulator->start() != 0 ||
+       bus->begin(&transport, emulator->ptyName(), speed, slaves, nrSlaves) != 0 || bus->setTiming(timing) != 0)
+    {
+        fprintf(stderr, "can't set up emulator and bus for %u baud, %d slaves\n", speed, nrSlaves);
+        goto cleanup;
+    }
+
+    for(int i = 0; i < nrSlaves; i++)
+    {
+        pkw[i] = {bus, i, {0, 0}, latencies, &nrLatencies, cycles, &pkwErrors};
+        clock_gettime(CLOCK_MONOTONIC, &pkw[i].queued);
+
+        if(USS_PKW_WORDS > 0)
+            bus->getParameterAsync(PARAM_NR_USS_ADDRESS, i, 0, pkwCallback, &pkw[i]);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(int i = 0; i < cycles; i++)
+    {
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuStart);
+        bus->send();
+        bus->getCycleStats(stats);
+
+        if(bus->receive() == -1)
+            timeouts++;
+
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuEnd);
+
+        // sleeping until the deadline and waiting for the response cost no CPU time, so this is the work per cycle
+        cpu[i] = ussTimespecDiffNs(cpuEnd, cpuStart) / NSEC_PER_USEC;
+        cpuSum += cpu[i];
+        jitters[i] = stats.lastJitter;
+
+        if(i > 0)
+            periods[nrPeriods++] = stats.lastPeriod;
+
+        int bucket = 0;
+
+        while(bucket < BENCH_JITTER_BUCKETS && stats.lastJitter > jitterBuckets[bucket])
+            bucket++;
+
+        jitterHist[bucket]++;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    bus->getCycleStats(stats);
+
+    qsort(periods, nrPeriods, sizeof(long), compareLong);
+    qsort(jitters, cycles, sizeof(long), compareLong);
+    qsort(cpu, cycles, sizeof(long), compareLong);
+    qsort(latencies, nrLatencies, sizeof(long), compareLong);
+
+    printf("{\"baudrate\":%u,\"slaves\":%d,\"pkw_words\":%d,\"pzd_words\":%d,\"cycles\":%d,\"timing_percentile\":%d,\"period_us\":%ld,"
+           "\"duration_s\":%.3f,\"telegrams_per_s\":%.2f,\"timeouts\":%d,\"overruns\":%lu,",
+           speed, nrSlaves, USS_PKW_WORDS, USS_PZD_WORDS, cycles, timing.percentile, stats.period,
+           ussTimespecDiffNs(end, start) / (double)NSEC_PER_SEC,
+           cycles * (double)NSEC_PER_SEC / ussTimespecDiffNs(end, start), timeouts, stats.overruns);
+
+    printf("\"cycle_us\":{\"min\":%ld,\"p50\":%ld,\"p90\":%ld,\"p99\":%ld,\"p999\":%ld,\"max\":%ld},",
+           percentile(periods, nrPeriods, 0), percentile(periods, nrPeriods, 50), percentile(periods, nrPeriods, 90),
+           percentile(periods, nrPeriods, 99), percentile(periods, nrPeriods, 99.9), percentile(periods, nrPeriods, 100));
+
+    printf("\"jitter_us\":{\"p50\":%ld,\"p99\":%ld,\"max\":%ld,\"hist_le\":[",
+           percentile(jitters, cycles, 50), percentile(jitters, cycles, 99), percentile(jitters, cycles, 100));
+
+    for(int i = 0; i < BENCH_JITTER_BUCKETS; i++)
+        printf("%s%ld", i ? "," : "", jitterBuckets[i]);
+
+    printf("],\"hist\":[");
+
+    for(int i = 0; i <= BENCH_JITTER_BUCKETS; i++)
+        printf("%s%ld", i ? "," : "", jitterHist[i]);
+
+    printf("]},\"cpu_us_per_cycle\":{\"mean\":%.1f,\"p50\":%ld,\"p99\":%ld,\"max\":%ld},",
+           (double)cpuSum / cycles, percentile(cpu, cycles, 50), percentile(cpu, cycles, 99), percentile(cpu, cycles, 100));
+
+    printf("\"pkw_latency_us\":{\"jobs\":%d,\"errors\":%d,\"p50\":%ld,\"p99\":%ld,\"max\":%ld}}\n",
+           nrLatencies, pkwErrors, percentile(latencies, nrLatencies, 50), percentile(latencies, nrLatencies, 99),
+           percentile(latencies, nrLatencies, 100));
+
+    fflush(stdout);
+    ret = 0;
+
+cleanup:
+    delete bus;
+    delete emulator;
+    delete[] periods;
+    delete[] jitters;
+    delete[] cpu;
+    delete[] latencies;
+
+    return ret;
+}
+
+int main(int argc, char *argv[])
+{
+    int speeds[BENCH_MAX_RUNS] = {9600, 19200, 38400, 57600};
+    int slaves[BENCH_MAX_RUNS] = {1, 2, 4, 8, 16, 31};
+    int nrSpeeds = 4;
+    int nrSlaves = 6;
+    int cyclesPerSlave = BENCH_CYCLES_PER_SLAVE;
+    int respDelayUs = 0;
+    int paramLag = 0;
+    int timingArgs[2] = {0, 0};
+    ussTimingConfig_t timing = {0, 0, 0};
+    int err = 0;
+    int opt;
+
+    while((opt = getopt(argc, argv, "b:n:c:d:L:t:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'b':
+                nrSpeeds = parseList(optarg, speeds, BENCH_MAX_RUNS);
+                break;
+
+            case 'n':
+                nrSlaves = parseList(optarg, slaves, BENCH_MAX_RUNS);
+                break;
+
+            case 'c':
+                cyclesPerSlave = atoi(optarg);
+                break;
+
+            case 'd':
+                respDelayUs = atoi(optarg);
+                break;
+
+            case 'L':
+                paramLag = atoi(optarg);
+                break;
+
+            case 't':
+                parseList(optarg, timingArgs, 2);
+                timing = {timingArgs[0], timingArgs[1], 2};
+                break;
+
+            default:
+                fprintf(stderr, "usage: %s [-b baud,baud,...] [-n slaves,slaves,...] [-c cycles_per_slave] [-d delay_us] [-L param_lag] [-t percentile,margin_us]\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+
+    if(cyclesPerSlave < 2)
+        cyclesPerSlave = 2;
+
+    for(int i = 0; i < nrSpeeds; i++)
+    {
+        for(int j = 0; j < nrSlaves; j++)
+        {
+            if(slaves[j] < 1 || slaves[j] > USS_SLAVES || slaves[j] > ADDR_BYTE_ADDR_MASK)
+            {
+                fprintf(stderr, "skipping %d slaves, must be 1 to %d\n", slaves[j], USS_SLAVES < ADDR_BYTE_ADDR_MASK ? USS_SLAVES : ADDR_BYTE_ADDR_MASK);
+                continue;
+            }
+
+            fprintf(stderr, "%d baud, %d slaves\n", speeds[i], slaves[j]);
+            err |= runBenchmark(speeds[i], slaves[j], slaves[j] * cyclesPerSlave, respDelayUs, paramLag, timing);
+        }
+    }
+
+    return err ? 1 : 0;
+}
@@ -0,0 +1,370 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   uss_replay.cpp
+ *   @brief  Replay of a capture written by USSCaptureTransport. By default the received bytes are fed into
+ *           USSParser in the chunks they were read and every telegram is decoded like receive() does, without
+ *           waiting, so a capture of hours is replayed in seconds and the parser can be profiled on it.
+ *           With -e the captured telegrams of the master are sent to emulated G110 slaves and their responses
+ *           are compared with the captured ones. -s paces the replay with the captured timestamps, 1 is real
+ *           time. -q prints the summary only.
+ *
+ *           usage: uss_replay [-e] [-s speed_factor] [-q] capture
+ *   @date   17.10.2026
+ */
+#include <Emulator/G110Emulator.h>
+#include <USSCapture.h>
+
+/**
+ * @brief Time to wait for the response of the emulator in ms
+ */
+#define REPLAY_RESPONSE_TIMEOUT_MS 100
+
+/**
+ * @struct state of the replay
+ */
+typedef struct
+{
+    USSParser parser;
+    byte adr;                   // address of the last telegram of the master, 0xFF before the first
+    bool answered;              // a response for it was decoded
+    bool quiet;
+    double timeMs;              // time of the record from the start of the capture
+    unsigned long telegrams;
+    unsigned long responses;
+    unsigned long otherAddress;
+    unsigned long timeouts;
+    unsigned long errors;
+    unsigned long differences;  // responses of the emulator not equal to the captured ones
+} replay_t;
+
+static void printHex(const byte data[], const int length)
+{
+    for(int i = 0; i < length; i++)
+        printf("%s%02X", i ? " " : "", data[i]);
+}
+
+/**
+ * @brief Print a telegram with its PZD, decoded from the end of the telegram like in receive()
+ */
+static void printTelegram(const replay_t &replay, const char *direction, const byte frame[], const int length)
+{
+    const int pzdOffset = length - 1 - PZD_LENGTH_CHARACTERS;
+
+    if(replay.quiet)
+        return;
+
+    printf("%12.3f %s adr %2d", replay.timeMs, direction, frame[USS_ADR_OFFSET] & ADDR_BYTE_ADDR_MASK);
+
+    if(pzdOffset >= USS_ADR_OFFSET + 1)
+        printf(" pzd1 0x%04X pzd2 %5u", ussGetWord(frame, pzdOffset), ussGetWord(frame, pzdOffset + 2));
+
+    printf("  ");
+    printHex(frame, length);
+    printf("\n");
+}
+
+/**
+ * @brief Decode the complete telegrams in the parser, the responses are checked against the last address
+ */
+static void parseResponses(replay_t &replay, const bool flush)
+{
+    byte frame[USS_MAX_TELEGRAM_LENGTH];
+    int length;
+
+    while((length = replay.parser.next(frame, USS_MAX_TELEGRAM_LENGTH, flush)) > 0)
+    {
+        if((frame[USS_ADR_OFFSET] & ADDR_BYTE_ADDR_MASK) != (replay.adr & ADDR_BYTE_ADDR_MASK) ||
+           length < TELEGRAM_OVERHEAD_CHARACTERS + PZD_LENGTH_CHARACTERS)
+        {
+            replay.otherAddress++;
+            printTelegram(replay, "rx?", frame, length);
+            continue;
+        }
+
+        replay.responses++;
+        replay.answered = true;
+        printTelegram(replay, "rx ", frame, length);
+    }
+}
+
+/**
+ * @brief Add received bytes to the parser in the free space it has
+ */
+static void feedParser(replay_t &replay, const byte data[], int length)
+{
+    while(length > 0)
+    {
+        int space;
+        byte *buffer = replay.parser.writeSpace(space);
+        const int n = space < length ? space : length;
+
+        memcpy(buffer, data, n);
+        replay.parser.commit(n);
+        data += n;
+        length -= n;
+        parseResponses(replay, false);
+    }
+}
+
+/**
+ * @brief Send a captured telegram to the emulator and compare its response with the captured response
+ */
+static void emulateTelegram(replay_t &replay, USSTransport &transport, const byte telegram[], const int length,
+                            const byte captured[], const int capturedLength)
+{
+    USSParser parser;
+    byte frame[USS_MAX_TELEGRAM_LENGTH];
+    struct timespec deadline;
+    int frameLength = 0;
+    int space;
+    int len;
+
+    if(transport.write(telegram, length) != 0)
+    {
+        replay.errors++;
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    ussTimespecAddNs(deadline, (long long)REPLAY_RESPONSE_TIMEOUT_MS * NSEC_PER_MSEC);
+
+    while((frameLength = parser.next(frame, USS_MAX_TELEGRAM_LENGTH)) == 0)
+    {
+        byte *buffer = parser.writeSpace(space);
+
+        if((len = transport.read(buffer, space, deadline)) <= 0)
+            break;
+
+        parser.commit(len);
+    }
+
+    // broadcasts and telegrams the emulator doesn't answer are equal when no response was captured either
+    if(frameLength == capturedLength && (frameLength == 0 || memcmp(frame, captured, frameLength) == 0))
+        return;
+
+    replay.differences++;
+
+    if(!replay.quiet)
+    {
+        printf("%12.3f differs adr %2d\n    captured ", replay.timeMs, telegram[USS_ADR_OFFSET] & ADDR_BYTE_ADDR_MASK);
+        printHex(captured, capturedLength);
+        printf("\n    emulated ");
+        printHex(frame, frameLength);
+        printf("\n");
+    }
+}
+
+/**
+ * @brief Addresses of the slaves in the telegrams of the master, for the emulator
+ */
+static int scanSlaves(const char *path, char slaves[])
+{
+    USSCaptureReader reader;
+    ussCaptureRecord_t record;
+    byte data[USS_PARSER_BUFFER_LENGTH];
+    unsigned int speed;
+    int nrSlaves = 0;
+
+    if(reader.open(path, speed) != 0)
+        return 0;
+
+    while(reader.next(record, data, sizeof(data)) == 1)
+    {
+        bool known = false;
+
+        if(record.direction != USS_CAPTURE_TX || record.length <= USS_ADR_OFFSET ||
+           (data[USS_ADR_OFFSET] & ADDR_BYTE_BROADCAST_FLAG))
+            continue;
+
+        for(int i = 0; i < nrSlaves; i++)
+            known |= slaves[i] == (data[USS_ADR_OFFSET] & ADDR_BYTE_ADDR_MASK);
+
+        if(!known && nrSlaves < USS_SLAVES)
+            slaves[nrSlaves++] = data[USS_ADR_OFFSET] & ADDR_BYTE_ADDR_MASK;
+    }
+
+    return nrSlaves;
+}
+
+int main(int argc, char *argv[])
+{
+    USSCaptureReader reader;
+    ussCaptureRecord_t record;
+    replay_t *replay = new replay_t();
+    G110Emulator *emulator = nullptr;
+    USSTermiosTransport transport;
+    byte data[USS_PARSER_BUFFER_LENGTH];
+    byte telegram[USS_MAX_TELEGRAM_LENGTH];
+    byte captured[USS_MAX_TELEGRAM_LENGTH];
+    int telegramLength = 0;
+    int capturedLength = 0;
+    bool emulate = false;
+    double speedFactor = 0;
+    uint64_t startNs = 0;
+    unsigned long records = 0;
+    unsigned int speed;
+    struct timespec start, end;
+    ussParserStats_t stats;
+    int opt;
+    int ret;
+
+    while((opt = getopt(argc, argv, "es:q")) != -1)
+    {
+        switch(opt)
+        {
+            case 'e':
+                emulate = true;
+                break;
+
+            case 's':
+                speedFactor = atof(optarg);
+                break;
+
+            case 'q':
+                replay->quiet = true;
+                break;
+
+            default:
+                fprintf(stderr, "usage: %s [-e] [-s speed_factor] [-q] capture\n", argv[0]);
+                return 1;
+        }
+    }
+
+    if(optind >= argc || reader.open(argv[optind], speed) != 0)
+    {
+        fprintf(stderr, "usage: %s [-e] [-s speed_factor] [-q] capture\n", argv[0]);
+        return 1;
+    }
+
+    if(emulate)
+    {
+        char slaves[USS_SLAVES];
+        const int nrSlaves = scanSlaves(argv[optind], slaves);
+        g110EmulatorConfig_t config = {0, 0, 0, 0, 1, 0};
+
+        emulator = new G110Emulator();
+
+        // the emulator answers at once, the pseudo terminal isn't slowed down to the baudrate
+        if(nrSlaves == 0 || emulator->begin(slaves, nrSlaves, config) != 0 || emulator->start() != 0 ||
+           transport.open(emulator->ptyName(), speed) != 0)
+        {
+            fprintf(stderr, "can't set up emulator for %d slaves\n", nrSlaves);
+            delete emulator;
+            return 1;
+        }
+    }
+
+    replay->adr = 0xFF;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while((ret = reader.next(record, data, sizeof(data))) == 1)
+    {
+        if(records++ == 0)
+            startNs = record.timeNs;
+
+        replay->timeMs = (record.timeNs - startNs) / 1e6;
+
+        if(speedFactor > 0)
+        {
+            struct timespec due = start;
+
+            ussTimespecAddNs(due, (long long)((record.timeNs - startNs) / speedFactor));
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, nullptr);
+        }
+
+        switch(record.direction)
+        {
+            case USS_CAPTURE_TX:
+                if(emulate && telegramLength > 0)
+                    emulateTelegram(*replay, transport, telegram, telegramLength, captured, capturedLength);
+
+                // bytes of the last response still in the parser are dropped like in send()
+                parseResponses(*replay, true);
+                replay->parser.reset();
+
+                if(replay->telegrams > 0 && !replay->answered && !(replay->adr & ADDR_BYTE_BROADCAST_FLAG))
+                    replay->timeouts++;
+
+                replay->telegrams++;
+                replay->adr = record.length > USS_ADR_OFFSET ? data[USS_ADR_OFFSET] : 0xFF;
+                replay->answered = false;
+                telegramLength = record.length < USS_MAX_TELEGRAM_LENGTH ? record.length : USS_MAX_TELEGRAM_LENGTH;
+                memcpy(telegram, data, telegramLength);
+                capturedLength = 0;
+                printTelegram(*replay, "tx ", data, record.length);
+                break;
+
+            case USS_CAPTURE_RX:
+                feedParser(*replay, data, record.length);
+
+                if(capturedLength + record.length <= USS_MAX_TELEGRAM_LENGTH)
+                {
+                    memcpy(captured + capturedLength, data, record.length);
+                    capturedLength += record.length;
+                }
+                break;
+
+            case USS_CAPTURE_TIMEOUT:
+                parseResponses(*replay, true);
+                break;
+
+            default:
+                replay->errors++;
+
+                if(!replay->quiet)
+                    printf("%12.3f error\n", replay->timeMs);
+                break;
+        }
+    }
+
+    if(emulate && telegramLength > 0)
+        emulateTelegram(*replay, transport, telegram, telegramLength, captured, capturedLength);
+
+    parseResponses(*replay, true);
+
+    if(replay->telegrams > 0 && !replay->answered && !(replay->adr & ADDR_BYTE_BROADCAST_FLAG))
+        replay->timeouts++;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    replay->parser.getStats(stats);
+
+    fprintf(stderr, "%lu records, %.3f s captured at %u baud, replayed in %.3f s%s\n", records, replay->timeMs / 1000,
+            speed, ussTimespecDiffNs(end, start) / (double)NSEC_PER_SEC, ret < 0 ? ", capture is truncated" : "");
+    fprintf(stderr, "%lu telegrams, %lu responses, %lu timeouts, %lu other address, %lu errors\n", replay->telegrams,
+            replay->responses, replay->timeouts, replay->otherAddress, replay->errors);
+    fprintf(stderr, "parser: %lu frames, %lu skipped bytes, %lu lge errors, %lu bcc errors, %lu truncated\n",
+            stats.frames, stats.skippedBytes, stats.lgeErrors, stats.bccErrors, stats.truncated);
+
+    if(emulate)
+    {
+        fprintf(stderr, "emulator: %lu responses differ\n", replay->differences);
+        transport.close();
+        emulator->stop();
+        delete emulator;
+    }
+
+    delete replay;
+
+    return 0;
+}
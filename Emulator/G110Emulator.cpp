@@ -0,0 +1,722 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   G110Emulator.cpp
+ *   @brief  class implementation for an emulator of G110 inverters on a pseudo terminal
+ *   @date   17.10.2026
+ */
+#include "G110Emulator.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <stdio.h>
+#include <termios.h>
+
+/**
+ * @struct factory setting of one emulated parameter
+ */
+typedef struct
+{
+    uint16_t param;
+    uint16_t index;
+    bool dword;
+    float value;
+} g110DefaultParam_t;
+
+/**
+ * @brief Factory settings of the parameters used by the G110 class, refer to G110 user manual
+ */
+static const g110DefaultParam_t defaultParams[] =
+{
+    {PARAM_NR_USER_ACCESS_LEVEL,        0, false, USER_ACCESS_LEVEL_STD},
+    {PARAM_NR_COMMISSIONING_PARAM,      0, false, QUICK_COMMISSIONING_READY},
+    {PARAM_NR_POWER_SETING,             0, false, POWER_SETTING_EUROPE},
+    {PARAM_NR_MOTOR_VOLTAGE_V,          0, false, 230},
+    {PARAM_NR_MOTOR_CURRENT_A,          0, true,  3.25f},
+    {PARAM_NR_MOTOR_POWER_KW_HP,        0, true,  0.75f},
+    {PARAM_NR_MOTOR_COS_PHI,            0, true,  0.0f},
+    {PARAM_NR_MOTOR_EFFICIENCY_FACTOR,  0, true,  0.0f},
+    {PARAM_NR_MOTOR_FREQ_HZ,            0, true,  50.0f},
+    {PARAM_NR_MOTOR_SPEED_PER_MINUTE,   0, false, 1395},
+    {PARAM_NR_MOTOR_COOLING,            0, false, 0},
+    {PARAM_NR_CALC_MOTOR_PARAMS,        0, false, CALC_MOTOR_PARAMS_NONE},
+    {PARAM_NR_MOTOR_OVERLOAD_FACTOR,    0, true,  150.0f},
+    {PARAM_NR_SEL_CMD_SOURCE,           0, false, 2},
+    {PARAM_NR_FUN_DIGITAL_IN_0,         0, false, FUN_DIGITAL_IN_ON_OFF1},
+    {PARAM_NR_FUN_DIGITAL_IN_1,         0, false, FUN_DIGITAL_IN_REVERSE},
+    {PARAM_NR_FUN_DIGITAL_IN_2,         0, false, FUN_DIGITAL_IN_FAULT_ACK},
+    {PARAM_NR_FUN_DIGITAL_IN_3,         0, false, FUN_DIGITAL_IN_FIXED_FREQ},
+    {PARAM_NR_FACTORY_RESET,            0, false, 0},
+    {PARAM_NR_SEL_FREQ_SETPOINT,        0, false, 2},
+    {PARAM_NR_MIN_FREQ_HZ,              0, true,  0.0f},
+    {PARAM_NR_MAX_FREQ_HZ,              0, true,  50.0f},
+    {PARAM_NR_RAMP_UP_TIME_S,           0, true,  10.0f},
+    {PARAM_NR_RAMP_DOWN_TIME_S,         0, true,  10.0f},
+    {PARAM_NR_ROUNDING_TIME_S,          0, true,  0.0f},
+    {PARAM_NR_OFF3_RAMP_DOWN_TIME_S,    0, true,  5.0f},
+    {PARAM_NR_CTL_MODE,                 0, false, 0},
+    {PARAM_NR_PULSE_FREQ_KHZ,           0, false, 8},
+    {PARAM_NR_REF_FREQ_HZ,              0, true,  50.0f},
+    {PARAM_NR_REF_VOLTAGE_V,            0, false, REF_VOLTAGE_V},
+    {PARAM_NR_REF_CURRENT_A,            0, true,  3.25f},
+    {PARAM_NR_USS_PZD_ACTUAL_VALUES,    0, false, USS_PZD_ACTUAL_STATUS_WORD},
+    {PARAM_NR_USS_PZD_ACTUAL_VALUES,    1, false, USS_PZD_ACTUAL_FREQ},
+    {PARAM_NR_USS_PZD_ACTUAL_VALUES,    2, false, 0},
+    {PARAM_NR_USS_PZD_ACTUAL_VALUES,    3, false, 0},
+    {PARAM_NR_USS_BAUDRATE,             0, false, USS_BAUDRATE_9600_BAUD},
+    {PARAM_NR_USS_ADDRESS,              0, false, 0},
+    {PARAM_NR_USS_PZD_LENGTH,           0, false, 2},
+    {PARAM_NR_USS_PKW_LENGTH,           0, false, USS_PKW_LENGTH_VARIABLE},
+    {PARAM_NR_END_QUICK_COMM,           0, false, 0},
+};
+
+static_assert(sizeof(defaultParams) / sizeof(defaultParams[0]) <= G110_EMU_PARAMS, "G110_EMU_PARAMS too small");
+
+/**
+ * @brief Conversion between float parameters and their double word representation in the telegram
+ */
+typedef union
+{
+    uint32_t u32;
+    float f32;
+} g110EmuValue_t;
+
+G110Emulator::G110Emulator() :
+    m_nrSlaves(0),
+    m_config(),
+    m_characterRuntime(0),
+    m_ptyFd(-1),
+    m_ptySlaveFd(-1),
+    m_ptyName{0},
+    m_recvBuffer{0},
+    m_parser(),
+    m_sendBuffer{0},
+    m_stats(),
+    m_run(false),
+    m_thread()
+{
+    pthread_mutex_init(&m_lock, nullptr);
+
+    m_sendBuffer[0] = STX_BYTE_STX;
+    m_sendBuffer[USS_LGE_OFFSET] = USS_LGE_VALUE;
+}
+
+G110Emulator::~G110Emulator()
+{
+    stop();
+
+    if(m_ptySlaveFd >= 0)
+        close(m_ptySlaveFd);
+
+    if(m_ptyFd >= 0)
+        close(m_ptyFd);
+
+    pthread_mutex_destroy(&m_lock);
+}
+
+int G110Emulator::begin(const char slaves[], const int nrSlaves, const g110EmulatorConfig_t &config)
+{
+    struct termios tty;
+
+    if(nrSlaves < 1 || nrSlaves > USS_SLAVES || slaves == nullptr || m_ptyFd >= 0)
+        return -1;
+
+    for(int i = 0; i < nrSlaves; i++)
+    {
+        if((byte)slaves[i] > ADDR_BYTE_ADDR_MASK)
+            return -1;
+
+        for(int j = 0; j < i; j++)
+        {
+            if(slaves[i] == slaves[j])
+                return -1;
+        }
+    }
+
+    m_ptyFd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+    if(m_ptyFd < 0)
+        return -1;
+
+    if(grantpt(m_ptyFd) != 0 || unlockpt(m_ptyFd) != 0 || ptsname_r(m_ptyFd, m_ptyName, sizeof(m_ptyName)) != 0)
+    {
+        close(m_ptyFd);
+        m_ptyFd = -1;
+        return -1;
+    }
+
+    // raw mode before the master opens the terminal, with echo the master would read its own telegrams
+    m_ptySlaveFd = open(m_ptyName, O_RDWR | O_NOCTTY);
+
+    if(m_ptySlaveFd < 0 || tcgetattr(m_ptySlaveFd, &tty) != 0)
+    {
+        if(m_ptySlaveFd >= 0)
+            close(m_ptySlaveFd);
+
+        close(m_ptyFd);
+        m_ptySlaveFd = -1;
+        m_ptyFd = -1;
+        m_ptyName[0] = 0;
+        return -1;
+    }
+
+    cfmakeraw(&tty);
+    tcsetattr(m_ptySlaveFd, TCSANOW, &tty);
+
+    m_config = config;
+    m_characterRuntime = config.speed > 0 ? (long)CHARACTER_RUNTIME_BASE_US * BAUDRATE_BASE * NSEC_PER_USEC / config.speed : 0;
+    m_nrSlaves = nrSlaves;
+
+    for(int i = 0; i < nrSlaves; i++)
+    {
+        emuSlave_t &slave = m_slaves[i];
+
+        memset(&slave, 0, sizeof(slave));
+        slave.addr = slaves[i];
+        slave.lag = -1;
+        clock_gettime(CLOCK_MONOTONIC, &slave.lastUpdate);
+        factoryReset(slave);
+    }
+
+    return 0;
+}
+
+const char *G110Emulator::ptyName() const
+{
+    return m_ptyName;
+}
+
+int G110Emulator::start()
+{
+    if(m_ptyFd < 0 || m_run.load())
+        return -1;
+
+    m_run.store(true);
+
+    if(pthread_create(&m_thread, nullptr, emulatorThread, this) != 0)
+    {
+        m_run.store(false);
+        return -1;
+    }
+
+    return 0;
+}
+
+void G110Emulator::stop()
+{
+    if(!m_run.load())
+        return;
+
+    m_run.store(false);
+    pthread_join(m_thread, nullptr);
+}
+
+void *G110Emulator::emulatorThread(void *arg)
+{
+    G110Emulator *emulator = static_cast<G110Emulator *>(arg);
+
+    // short timeout, so stop() doesn't wait long when the master is silent
+    while(emulator->m_run.load())
+    {
+        if(emulator->poll(100) < 0)
+            break;
+    }
+
+    return nullptr;
+}
+
+int G110Emulator::poll(const int timeoutMs)
+{
+    struct pollfd pfd = {m_ptyFd, POLLIN, 0};
+    struct timespec now;
+    ussParserStats_t before;
+    ussParserStats_t after;
+    unsigned long badFrames = 0;
+    int processed = 0;
+    int space;
+    byte *buffer;
+    int len;
+
+    if(m_ptyFd < 0)
+        return -1;
+
+    if(::poll(&pfd, 1, timeoutMs) <= 0)
+        return 0;
+
+    buffer = m_parser.writeSpace(space);
+    len = read(m_ptyFd, buffer, space);
+
+    if(len < 0)
+        return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    m_parser.commit(len);
+    m_parser.getStats(before);
+
+    // like on a real bus the data is a stream of bytes, the parser checks LGE and BCC and resynchronizes on the
+    // next STX after errors, the emulated slaves only accept telegrams with the length of the master
+    while((len = m_parser.next(m_recvBuffer, USS_MAX_TELEGRAM_LENGTH)) > 0)
+    {
+        if(len != USS_BUFFER_LENGTH)
+        {
+            badFrames++;
+            continue;
+        }
+
+        processTelegram(now);
+        processed++;
+    }
+
+    m_parser.getStats(after);
+    badFrames += (after.lgeErrors - before.lgeErrors) + (after.bccErrors - before.bccErrors);
+
+    if(badFrames > 0)
+    {
+        pthread_mutex_lock(&m_lock);
+        m_stats.badFrames += badFrames;
+        pthread_mutex_unlock(&m_lock);
+    }
+
+    return processed;
+}
+
+void G110Emulator::processTelegram(const struct timespec &received)
+{
+    const byte addr = m_recvBuffer[USS_ADR_OFFSET];
+    const uint16_t ctlword = ussGetWord(m_recvBuffer, USS_PZD_OFFSET);
+    const uint16_t mainsetpoint = ussGetWord(m_recvBuffer, USS_PZD_OFFSET + 2);
+    struct timespec deadline = received;
+    int slaveIndex;
+
+    pthread_mutex_lock(&m_lock);
+
+    // a broadcast is taken by all slaves and never answered
+    if(addr & ADDR_BYTE_BROADCAST_FLAG)
+    {
+        for(int i = 0; i < m_nrSlaves; i++)
+            updateDrive(m_slaves[i], ctlword, mainsetpoint, received);
+
+        m_stats.broadcasts++;
+        pthread_mutex_unlock(&m_lock);
+        return;
+    }
+
+    slaveIndex = findSlave(addr & ADDR_BYTE_ADDR_MASK);
+
+    // telegram for a slave that isn't emulated, on a real bus another slave would answer
+    if(slaveIndex < 0)
+    {
+        pthread_mutex_unlock(&m_lock);
+        return;
+    }
+
+    m_stats.received++;
+
+    // a dropped telegram is lost on the wire, the slave neither executes nor answers it
+    if(fault(m_config.dropPercent))
+    {
+        m_stats.dropped++;
+        pthread_mutex_unlock(&m_lock);
+        return;
+    }
+
+    emuSlave_t &slave = m_slaves[slaveIndex];
+
+    if(USS_PKW_WORDS > 0)
+    {
+        uint32_t pwe = ussGetWord(m_recvBuffer, USS_PZD_OFFSET - 2);
+
+        if(USS_PKW_WORDS == 4)
+            pwe |= (uint32_t)ussGetWord(m_recvBuffer, USS_PWE_OFFSET) << 16;
+
+        const uint16_t pke = ussGetWord(m_recvBuffer, USS_PKE_OFFSET);
+        const uint16_t ind = ussGetWord(m_recvBuffer, USS_IND_OFFSET);
+
+        // a new job is processed only after paramLag telegrams, until then the response of the old one is sent
+        if(pke != slave.reqPke || ind != slave.reqInd || pwe != slave.reqPwe)
+        {
+            slave.reqPke = pke;
+            slave.reqInd = ind;
+            slave.reqPwe = pwe;
+            slave.lag = m_config.paramLag > 0 ? m_config.paramLag : 0;
+        }
+
+        if(slave.lag > 0)
+        {
+            slave.lag--;
+        }
+        else if(slave.lag == 0)
+        {
+            processParamJob(slave, pke, ind, pwe);
+            slave.lag = -1;
+        }
+    }
+
+    updateDrive(slave, ctlword, mainsetpoint, received);
+
+    m_sendBuffer[USS_ADR_OFFSET] = slave.addr;
+    memset(m_sendBuffer + USS_PKW_OFFSET, 0, USS_BCC_OFFSET - USS_PKW_OFFSET);
+
+    if(USS_PKW_WORDS > 0)
+    {
+        ussPutWord(m_sendBuffer, USS_PKE_OFFSET, slave.respPke);
+        ussPutWord(m_sendBuffer, USS_IND_OFFSET, slave.respInd);
+
+        if(USS_PKW_WORDS == 4)
+            ussPutWord(m_sendBuffer, USS_PWE_OFFSET, slave.respPwe >> 16);
+
+        ussPutWord(m_sendBuffer, USS_PZD_OFFSET - 2, slave.respPwe & 0xFFFF);
+    }
+
+    ussPutWord(m_sendBuffer, USS_PZD_OFFSET, slave.statusword);
+    ussPutWord(m_sendBuffer, USS_PZD_OFFSET + 2, slave.mainactualvalue);
+
+    // additional actual values as selected with P2019, PZD words without an index in it stay 0
+    for(int i = 0; i < USS_PZD_ADD_WORDS; i++)
+    {
+        const int pos = findParam(slave, PARAM_NR_USS_PZD_ACTUAL_VALUES, 2 + i, nullptr);
+
+        if(pos >= 0)
+            ussPutWord(m_sendBuffer, USS_PZD_ADD_OFFSET + 2 * i, actualValue(slave, slave.params[pos].value));
+    }
+    m_sendBuffer[USS_BCC_OFFSET] = ussBCC(m_sendBuffer, USS_BCC_OFFSET);
+
+    if(fault(m_config.corruptPercent))
+    {
+        m_sendBuffer[USS_BCC_OFFSET] ^= 0xFF;
+        m_stats.corrupted++;
+    }
+
+    pthread_mutex_unlock(&m_lock);
+
+    // the pseudo terminal delivers the telegram at once, on the wire the request and the response both
+    // take their runtime, the response is sent when its last character would have arrived at the master
+    ussTimespecAddNs(deadline, 2LL * USS_BUFFER_LENGTH * m_characterRuntime + (long long)m_config.respDelayUs * NSEC_PER_USEC);
+
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR);
+
+    for(int written = 0, ret; written < USS_BUFFER_LENGTH; written += ret)
+    {
+        ret = write(m_ptyFd, m_sendBuffer + written, USS_BUFFER_LENGTH - written);
+
+        if(ret < 0 && errno == EAGAIN)
+        {
+            struct pollfd pfd = {m_ptyFd, POLLOUT, 0};
+
+            ::poll(&pfd, 1, -1);
+            ret = 0;
+        }
+        else if(ret < 0 && errno != EINTR)
+        {
+            return;
+        }
+        else if(ret < 0)
+        {
+            ret = 0;
+        }
+    }
+
+    pthread_mutex_lock(&m_lock);
+    m_stats.answered++;
+    pthread_mutex_unlock(&m_lock);
+}
+
+void G110Emulator::processParamJob(emuSlave_t &slave, const uint16_t pke, const uint16_t ind, const uint32_t pwe)
+{
+    const uint16_t param = pke & PKE_WORD_PARAM_MASK;
+    const uint16_t ak = pke & PKE_WORD_AK_MASK;
+    int err = G110_EMU_ERR_TASK;
+    int pos;
+
+    // no task is answered with no response
+    if(ak == PKE_WORD_AK_NO_TASK)
+    {
+        slave.respPke = PKE_WORD_AK_NO_RESP;
+        slave.respInd = 0;
+        slave.respPwe = 0;
+        return;
+    }
+
+    slave.respInd = ind;
+    pos = findParam(slave, param, ind, &err);
+
+    if(pos >= 0)
+    {
+        emuParam_t &p = slave.params[pos];
+
+        if(ak == PKE_WORD_AK_REQ_PWE)
+        {
+            slave.respPke = (p.dword ? PKE_WORD_AK_TRD_PWE : PKE_WORD_AK_TRW_PWE) | param;
+            slave.respPwe = p.value;
+            m_stats.paramReads++;
+            return;
+        }
+
+        if((ak == PKE_WORD_AK_CHW_PWE && !p.dword) || (ak == PKE_WORD_AK_CHD_PWE && p.dword))
+        {
+            p.value = p.dword ? pwe : (pwe & 0xFFFF);
+            slave.respPke = (p.dword ? PKE_WORD_AK_TRD_PWE : PKE_WORD_AK_TRW_PWE) | param;
+            slave.respPwe = p.value;
+            m_stats.paramWrites++;
+
+            // parameters that trigger an action on the inverter and fall back to 0 when it is done
+            if(param == PARAM_NR_FACTORY_RESET && p.value == 1)
+            {
+                factoryReset(slave);
+            }
+            else if(param == PARAM_NR_END_QUICK_COMM && p.value != 0)
+            {
+                p.value = 0;
+                slave.params[findParam(slave, PARAM_NR_COMMISSIONING_PARAM, 0, nullptr)].value = QUICK_COMMISSIONING_READY;
+            }
+            else if(param == PARAM_NR_CALC_MOTOR_PARAMS)
+            {
+                p.value = CALC_MOTOR_PARAMS_NONE;
+            }
+
+            return;
+        }
+
+        err = (ak == PKE_WORD_AK_CHW_PWE || ak == PKE_WORD_AK_CHD_PWE) ? G110_EMU_ERR_DATA_TYPE : G110_EMU_ERR_TASK;
+    }
+
+    slave.respPke = PKE_WORD_AK_CANT_EXECUTE | param;
+    slave.respPwe = err;
+    m_stats.paramErrors++;
+}
+
+void G110Emulator::updateDrive(emuSlave_t &slave, const uint16_t ctlword, const uint16_t mainsetpoint, const struct timespec &now)
+{
+    g110EmuValue_t maxFreq, refFreq, rampTime;
+    const bool noOFF2 = ctlword & CTL_WORD_OFF2_OP_COND;
+    const bool noOFF3 = ctlword & CTL_WORD_OFF3_OP_COND;
+    const bool on = (ctlword & CTL_WORD_ON_OFF1_ON) && (ctlword & CTL_WORD_ENABLE_ENABLE) && noOFF2 && noOFF3;
+    const float dt = ussTimespecDiffNs(now, slave.lastUpdate) / (float)NSEC_PER_SEC;
+    float target = 0.0f;
+    float step;
+
+    slave.ctlword = ctlword;
+    slave.mainsetpoint = mainsetpoint;
+    slave.lastUpdate = now;
+
+    if(on && (ctlword & CTL_WORD_INHIBIT_RAMP_OP_COND) && (ctlword & CTL_WORD_ENABLE_SETPOINT_ENABLE))
+        target = (ctlword & CTL_WORD_REVERSE_FALG) ? -(float)mainsetpoint : (float)mainsetpoint;
+
+    maxFreq.u32 = slave.params[findParam(slave, PARAM_NR_MAX_FREQ_HZ, 0, nullptr)].value;
+    refFreq.u32 = slave.params[findParam(slave, PARAM_NR_REF_FREQ_HZ, 0, nullptr)].value;
+
+    // ramp times are given from 0 to max frequency, main setpoint FREQUENCY_CALC_BASE is the reference frequency
+    if(!noOFF3)
+        rampTime.u32 = slave.params[findParam(slave, PARAM_NR_OFF3_RAMP_DOWN_TIME_S, 0, nullptr)].value;
+    else if(fabsf(target) > fabsf(slave.actualvalue))
+        rampTime.u32 = slave.params[findParam(slave, PARAM_NR_RAMP_UP_TIME_S, 0, nullptr)].value;
+    else
+        rampTime.u32 = slave.params[findParam(slave, PARAM_NR_RAMP_DOWN_TIME_S, 0, nullptr)].value;
+
+    if(!noOFF2 || rampTime.f32 <= 0.0f || refFreq.f32 <= 0.0f)
+        step = INFINITY;
+    else
+        step = FREQUENCY_CALC_BASE * maxFreq.f32 / refFreq.f32 / rampTime.f32 * dt;
+
+    // ramp generator on hold keeps the actual value
+    if(!(ctlword & CTL_WORD_ENABLE_RAMP_ENABLE) && on)
+        step = 0.0f;
+
+    if(fabsf(target - slave.actualvalue) <= step)
+        slave.actualvalue = target;
+    else if(target > slave.actualvalue)
+        slave.actualvalue += step;
+    else
+        slave.actualvalue -= step;
+
+    slave.mainactualvalue = (uint16_t)lroundf(fabsf(slave.actualvalue));
+    slave.statusword = 0;
+
+    if(noOFF2 && noOFF3)
+        slave.statusword |= STATUS_WORD_SWITCH_READY;
+    if(noOFF2 && noOFF3 && (ctlword & CTL_WORD_ON_OFF1_ON))
+        slave.statusword |= STATUS_WORD_READY;
+    if(on || slave.mainactualvalue != 0)
+        slave.statusword |= STATUS_WORD_OP_ENABLED_ENABLED;
+    if(noOFF2)
+        slave.statusword |= STATUS_WORD_OFF2_NO_OFF2;
+    if(noOFF3)
+        slave.statusword |= STATUS_WORD_OFF3_NO_OFF3;
+    if(!noOFF2 || !noOFF3)
+        slave.statusword |= STATUS_WORD_SWITCH_INHIBIT_INHIBIT;
+    if(slave.actualvalue == target)
+        slave.statusword |= STATUS_WORD_SETPOINT_TOL_IN_RANGE;
+    if(ctlword & CTL_WORD_CTL_PLC_CTL_PLC)
+        slave.statusword |= STATUS_WORD_CTL_REQ_CTL_REQ;
+    if(on && slave.mainactualvalue >= mainsetpoint)
+        slave.statusword |= STATUS_WORD_F_N_REACHED_REACHED;
+    if(slave.actualvalue >= 0.0f)
+        slave.statusword |= STATUS_WORD_MOTOR_RUNS_RIGHT_FLAG;
+}
+
+bool G110Emulator::fault(const int percent)
+{
+    if(percent <= 0)
+        return false;
+
+    return (rand_r(&m_config.seed) % 100) < percent;
+}
+
+uint16_t G110Emulator::actualValue(const emuSlave_t &slave, const uint32_t source)
+{
+    g110EmuValue_t motorCurrent, refCurrent;
+    const uint32_t motorVoltage = slave.params[findParam(slave, PARAM_NR_MOTOR_VOLTAGE_V, 0, nullptr)].value;
+    const uint32_t refVoltage = slave.params[findParam(slave, PARAM_NR_REF_VOLTAGE_V, 0, nullptr)].value;
+    const float speed = fabsf(slave.actualvalue) / FREQUENCY_CALC_BASE;
+    float value;
+
+    motorCurrent.u32 = slave.params[findParam(slave, PARAM_NR_MOTOR_CURRENT_A, 0, nullptr)].value;
+    refCurrent.u32 = slave.params[findParam(slave, PARAM_NR_REF_CURRENT_A, 0, nullptr)].value;
+
+    // simple motor model: V/f output voltage, magnetizing current plus a load current rising with speed,
+    // DC-link voltage of a rectified mains with the motor voltage, values scaled with the reference values
+    switch(source)
+    {
+        case USS_PZD_ACTUAL_STATUS_WORD:
+            return slave.statusword;
+
+        case USS_PZD_ACTUAL_FREQ:
+            return slave.mainactualvalue;
+
+        case USS_PZD_ACTUAL_OUTPUT_VOLTAGE:
+            value = refVoltage > 0 ? motorVoltage * speed / refVoltage : 0.0f;
+            break;
+
+        case USS_PZD_ACTUAL_DC_LINK_VOLTAGE:
+            value = refVoltage > 0 ? motorVoltage * sqrtf(2.0f) / refVoltage : 0.0f;
+            break;
+
+        case USS_PZD_ACTUAL_OUTPUT_CURRENT:
+            if(!(slave.statusword & STATUS_WORD_OP_ENABLED_ENABLED) || refCurrent.f32 <= 0.0f)
+                value = 0.0f;
+            else
+                value = motorCurrent.f32 * (0.3f + 0.7f * fminf(speed, 1.0f)) / refCurrent.f32;
+            break;
+
+        default:
+            return 0;
+    }
+
+    return (uint16_t)lroundf(fminf(value, 1.99f) * FREQUENCY_CALC_BASE);
+}
+
+void G110Emulator::factoryReset(emuSlave_t &slave)
+{
+    g110EmuValue_t value;
+
+    slave.nrParams = sizeof(defaultParams) / sizeof(defaultParams[0]);
+
+    for(int i = 0; i < slave.nrParams; i++)
+    {
+        emuParam_t &p = slave.params[i];
+
+        p.param = defaultParams[i].param;
+        p.index = defaultParams[i].index;
+        p.dword = defaultParams[i].dword;
+        value.f32 = defaultParams[i].value;
+        p.value = p.dword ? value.u32 : (uint32_t)defaultParams[i].value;
+    }
+
+    slave.params[findParam(slave, PARAM_NR_USS_ADDRESS, 0, nullptr)].value = slave.addr;
+}
+
+int G110Emulator::findParam(const emuSlave_t &slave, const uint16_t param, const uint16_t index, int *err)
+{
+    bool known = false;
+
+    for(int i = 0; i < slave.nrParams; i++)
+    {
+        if(slave.params[i].param != param)
+            continue;
+
+        if(slave.params[i].index == index)
+            return i;
+
+        known = true;
+    }
+
+    if(err != nullptr)
+        *err = known ? G110_EMU_ERR_SUBINDEX : G110_EMU_ERR_ILLEGAL_PNU;
+
+    return -1;
+}
+
+int G110Emulator::findSlave(const byte addr) const
+{
+    for(int i = 0; i < m_nrSlaves; i++)
+    {
+        if(m_slaves[i].addr == addr)
+            return i;
+    }
+
+    return -1;
+}
+
+void G110Emulator::getStats(g110EmulatorStats_t &stats) const
+{
+    pthread_mutex_lock(&m_lock);
+    stats = m_stats;
+    pthread_mutex_unlock(&m_lock);
+}
+
+int G110Emulator::getParameter(const int slaveIndex, const uint16_t param, const uint16_t index, uint32_t &value) const
+{
+    int pos;
+
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves)
+        return -1;
+
+    pthread_mutex_lock(&m_lock);
+    pos = findParam(m_slaves[slaveIndex], param, index, nullptr);
+
+    if(pos >= 0)
+        value = m_slaves[slaveIndex].params[pos].value;
+
+    pthread_mutex_unlock(&m_lock);
+
+    return pos >= 0 ? 0 : -1;
+}
+
+int G110Emulator::setParameter(const int slaveIndex, const uint16_t param, const uint16_t index, const uint32_t value)
+{
+    int pos;
+
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves)
+        return -1;
+
+    pthread_mutex_lock(&m_lock);
+    pos = findParam(m_slaves[slaveIndex], param, index, nullptr);
+
+    if(pos >= 0)
+        m_slaves[slaveIndex].params[pos].value = value;
+
+    pthread_mutex_unlock(&m_lock);
+
+    return pos >= 0 ? 0 : -1;
+}
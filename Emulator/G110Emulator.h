@@ -0,0 +1,279 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   G110Emulator.h
+ *   @brief  class definition for an emulator of one or more G110 inverters on a pseudo terminal,
+ *           answers the telegrams of the USS master like the slaves on a real bus.
+ *   @date   17.10.2026
+ */
+#ifndef G110_EMULATOR_H
+#define G110_EMULATOR_H
+
+#include <pthread.h>
+#include <atomic>
+#include <G110.h>
+
+/**
+ * @brief Max number of parameters emulated per slave
+ */
+#define G110_EMU_PARAMS            48
+
+/**
+ * @brief Error numbers in PWE of a response with AK 7 (task can't be executed), refer to G110 user manual
+ */
+#define G110_EMU_ERR_ILLEGAL_PNU   0
+#define G110_EMU_ERR_SUBINDEX      3
+#define G110_EMU_ERR_DATA_TYPE     5
+#define G110_EMU_ERR_TASK          106
+
+/**
+ * @struct structure definition for the configuration of the emulator
+ */
+typedef struct
+{
+    unsigned int speed;         // baudrate, telegrams are held back for their runtime on the wire, 0 to answer at once
+    int respDelayUs;            // processing time of the slave before the response starts
+    int dropPercent;            // share of correct telegrams that are not answered
+    int corruptPercent;         // share of responses sent with a wrong BCC
+    unsigned int seed;          // seed for drop and corruption, the same seed gives the same sequence of faults
+    int paramLag;               // telegrams until a new PKW job is answered, the old response is repeated until
+                                // then like on a real drive, 0 to answer it in the same telegram
+} g110EmulatorConfig_t;
+
+/**
+ * @struct structure definition for the counters of the emulator
+ */
+typedef struct
+{
+    unsigned long received;     // correct telegrams for one of the emulated slaves
+    unsigned long broadcasts;
+    unsigned long answered;
+    unsigned long dropped;
+    unsigned long corrupted;
+    unsigned long badFrames;    // telegrams with wrong length or BCC, skipped up to the next STX
+    unsigned long paramWrites;
+    unsigned long paramReads;
+    unsigned long paramErrors;  // parameter jobs answered with AK 7
+} g110EmulatorStats_t;
+
+class G110Emulator
+{
+    public:
+
+    /**
+     * @brief Constructor for G110Emulator class, initializes the members
+     *
+     * @return none
+     */
+    G110Emulator();
+
+    /**
+     * @brief Destructor for G110Emulator class, stops the emulator thread and closes the pseudo terminal
+     */
+    ~G110Emulator();
+
+    /**
+     * @brief Open a pseudo terminal and set up the emulated slaves with the default parameter values
+     *
+     * @param slaves array with USS slave addresses to emulate, addresses 0 to 31 and each only once
+     * @param nrSlaves number of emulated slaves, 1 to USS_SLAVES
+     * @param config timing and fault configuration
+     * @retval 0: success
+     * @retval -1: failure
+     *
+     * The telegram layout (USS_PKW_WORDS, USS_PZD_WORDS) is the same as for the USS class, so master and
+     * emulator must be built with the same settings. The name of the terminal for USS::begin() is returned
+     * by ptyName().
+     */
+    int begin(const char slaves[], const int nrSlaves, const g110EmulatorConfig_t &config);
+
+    /**
+     * @brief Get the name of the pseudo terminal the master opens
+     *
+     * @return device name like "/dev/pts/3", empty string before begin()
+     */
+    const char *ptyName() const;
+
+    /**
+     * @brief Start the emulator thread, which answers the telegrams until stop() is called
+     *
+     * @retval 0: success
+     * @retval -1: failure, begin() not called successfully or thread already running
+     */
+    int start();
+
+    /**
+     * @brief Stop the emulator thread
+     *
+     * @return none
+     */
+    void stop();
+
+    /**
+     * @brief Wait for telegrams and answer them, for programs running the emulator without start()
+     *
+     * @param timeoutMs max time to wait for data from the master, -1 to wait without limit
+     * @return number of telegrams processed, -1 on error of the pseudo terminal
+     */
+    int poll(const int timeoutMs);
+
+    /**
+     * @brief Get the counters of the emulator
+     *
+     * @param stats structure the actual counters are copied to
+     * @return none
+     */
+    void getStats(g110EmulatorStats_t &stats) const;
+
+    /**
+     * @brief Get a parameter of an emulated slave, like the master would read it
+     *
+     * @param slaveIndex index in array of slave addresses given to begin()
+     * @param param parameter number
+     * @param index parameter index
+     * @param value parameter value, float parameters as IEEE 754 bits
+     * @retval 0: success
+     * @retval -1: illegal slave, parameter or index
+     */
+    int getParameter(const int slaveIndex, const uint16_t param, const uint16_t index, uint32_t &value) const;
+
+    /**
+     * @brief Set a parameter of an emulated slave directly, without a telegram
+     *
+     * @param slaveIndex index in array of slave addresses given to begin()
+     * @param param parameter number
+     * @param index parameter index
+     * @param value parameter value, float parameters as IEEE 754 bits
+     * @retval 0: success
+     * @retval -1: illegal slave, parameter or index
+     */
+    int setParameter(const int slaveIndex, const uint16_t param, const uint16_t index, const uint32_t value);
+
+    private:
+
+    /**
+     * @struct one parameter of an emulated slave
+     */
+    typedef struct
+    {
+        uint16_t param;
+        uint16_t index;
+        bool dword;                 // float parameter, transferred as double word
+        uint32_t value;
+    } emuParam_t;
+
+    /**
+     * @struct state of one emulated slave
+     */
+    typedef struct
+    {
+        byte addr;
+        uint16_t ctlword;
+        uint16_t mainsetpoint;
+        uint16_t statusword;
+        uint16_t mainactualvalue;
+        float actualvalue;          // main actual value while ramping, in units of the main setpoint
+        struct timespec lastUpdate;
+        uint16_t respPke;           // the slave repeats its last PKW response until it processed a new job
+        uint16_t respInd;
+        uint32_t respPwe;
+        uint16_t reqPke;            // last PKW request, a different one is a new job
+        uint16_t reqInd;
+        uint32_t reqPwe;
+        int lag;                    // telegrams until the job is processed, -1 when it is processed
+        emuParam_t params[G110_EMU_PARAMS];
+        int nrParams;
+    } emuSlave_t;
+
+    /**
+     * @brief Thread function of the emulator thread
+     *
+     * @param arg pointer to the G110Emulator instance
+     * @return nullptr
+     */
+    static void *emulatorThread(void *arg);
+
+    /**
+     * @brief Set all parameters of a slave to factory settings
+     */
+    static void factoryReset(emuSlave_t &slave);
+
+    /**
+     * @brief Search a parameter of a slave
+     *
+     * @param err error number for the AK 7 response when the parameter isn't found, may be nullptr
+     * @return position of the parameter in the table, -1 when there is no parameter with this number and index
+     */
+    static int findParam(const emuSlave_t &slave, const uint16_t param, const uint16_t index, int *err);
+
+    /**
+     * @brief Find the slave for an address
+     *
+     * @return index of the slave, -1 when the address isn't emulated
+     */
+    int findSlave(const byte addr) const;
+
+    /**
+     * @brief Process a complete telegram in the receive buffer and send the response
+     */
+    void processTelegram(const struct timespec &received);
+
+    /**
+     * @brief Execute the PKW job of a telegram and set the PKW response of the slave
+     */
+    void processParamJob(emuSlave_t &slave, const uint16_t pke, const uint16_t ind, const uint32_t pwe);
+
+    /**
+     * @brief Take over control word and setpoint and move the drive state and main actual value
+     */
+    void updateDrive(emuSlave_t &slave, const uint16_t ctlword, const uint16_t mainsetpoint, const struct timespec &now);
+
+    /**
+     * @brief Actual value of the drive for a PZD word, like selected with P2019
+     *
+     * @param source number of the parameter with the actual value (r0021, r0027, ...)
+     * @return actual value scaled for the PZD word, 0 for sources that aren't emulated
+     */
+    static uint16_t actualValue(const emuSlave_t &slave, const uint32_t source);
+
+    /**
+     * @brief Decide with the configured probability if a fault is injected
+     */
+    bool fault(const int percent);
+
+    emuSlave_t m_slaves[USS_SLAVES];
+    int m_nrSlaves;
+    g110EmulatorConfig_t m_config;
+    long m_characterRuntime;              // runtime of one character on the wire in ns, 0 for no wire time
+    int m_ptyFd;                          // master side of the pseudo terminal
+    int m_ptySlaveFd;                     // slave side kept open, so the master side has no hangup between programs
+    char m_ptyName[64];
+    byte m_recvBuffer[USS_MAX_TELEGRAM_LENGTH];
+    USSParser m_parser;                   // received bytes not parsed yet
+    byte m_sendBuffer[USS_BUFFER_LENGTH];
+    g110EmulatorStats_t m_stats;
+    mutable pthread_mutex_t m_lock;       // protects slaves and counters against the application
+    std::atomic<bool> m_run;
+    pthread_t m_thread;
+};
+
+#endif
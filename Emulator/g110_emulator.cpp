@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   g110_emulator.cpp
+ *   @brief  G110 emulator program, emulates one or more inverters on a pseudo terminal, so USS and G110
+ *           can be run without a Raspberry Pi, RS485 converter and inverter. Give the printed terminal
+ *           name to USS::begin() with dePin -1.
+ *
+ *           usage: g110_emulator [-a addr,addr,...] [-b baudrate] [-d delay_us] [-D drop_%] [-C corrupt_%]
+ *                                [-s seed] [-L param_lag] [-l link]
+ *   @date   17.10.2026
+ */
+#include "G110Emulator.h"
+#include <signal.h>
+#include <stdio.h>
+
+static volatile sig_atomic_t run = 1;
+
+static void stopHandler(int sig)
+{
+    (void)sig;
+    run = 0;
+}
+
+int main(int argc, char *argv[])
+{
+    G110Emulator emulator;
+    g110EmulatorStats_t stats;
+    g110EmulatorConfig_t config = {9600, 0, 0, 0, 1, 0};
+    char slaves[USS_SLAVES] = {1};
+    int nrSlaves = 1;
+    const char *link = nullptr;
+    int opt;
+
+    while((opt = getopt(argc, argv, "a:b:d:D:C:s:L:l:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'a':
+                nrSlaves = 0;
+
+                for(char *addr = strtok(optarg, ","); addr != nullptr && nrSlaves < USS_SLAVES; addr = strtok(nullptr, ","))
+                    slaves[nrSlaves++] = atoi(addr);
+                break;
+
+            case 'b':
+                config.speed = atoi(optarg);
+                break;
+
+            case 'd':
+                config.respDelayUs = atoi(optarg);
+                break;
+
+            case 'D':
+                config.dropPercent = atoi(optarg);
+                break;
+
+            case 'C':
+                config.corruptPercent = atoi(optarg);
+                break;
+
+            case 's':
+                config.seed = atoi(optarg);
+                break;
+
+            case 'L':
+                config.paramLag = atoi(optarg);
+                break;
+
+            case 'l':
+                link = optarg;
+                break;
+
+            default:
+                fprintf(stderr, "usage: %s [-a addr,addr,...] [-b baudrate] [-d delay_us] [-D drop_%%] [-C corrupt_%%] "
+                                "[-s seed] [-L param_lag] [-l link]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    if(emulator.begin(slaves, nrSlaves, config) != 0)
+    {
+        fprintf(stderr, "can't open pseudo terminal or illegal slave addresses\n");
+        return 1;
+    }
+
+    if(link != nullptr)
+    {
+        unlink(link);
+
+        if(symlink(emulator.ptyName(), link) != 0)
+        {
+            perror("symlink");
+            return 1;
+        }
+    }
+
+    printf("%s\n", emulator.ptyName());
+    fflush(stdout);
+
+    signal(SIGINT, stopHandler);
+    signal(SIGTERM, stopHandler);
+
+    while(run)
+    {
+        if(emulator.poll(100) < 0)
+            break;
+    }
+
+    if(link != nullptr)
+        unlink(link);
+
+    emulator.getStats(stats);
+    fprintf(stderr, "received %lu broadcasts %lu answered %lu dropped %lu corrupted %lu bad %lu "
+                    "param writes %lu reads %lu errors %lu\n",
+            stats.received, stats.broadcasts, stats.answered, stats.dropped, stats.corrupted, stats.badFrames,
+            stats.paramWrites, stats.paramReads, stats.paramErrors);
+
+    return 0;
+}
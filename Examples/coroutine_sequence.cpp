@@ -0,0 +1,124 @@
+/**
+ * copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   coroutine_sequence.cpp
+ *   @brief  example for drive sequences as C++20 coroutines, both drives run
+ *           their own sequence at the same time on the main thread
+ *   @date   17.10.2026
+ */
+
+#include <G110.h>
+#include <USS.h>
+#include <USSCoroutine.h>
+#include <stdio.h>
+
+#define DE_PIN 5
+#define NR_SLAVES 2
+
+USS uss;
+USSAsync async(&uss);
+
+G110 drives[NR_SLAVES];
+
+USSTask reverse(G110 &drive, const int index, const float freq)
+{
+  drive.setFrequency(freq);
+
+  // the setpoint is left while the drive ramps, so wait for it to leave the range first
+  co_await async.sleep(500);
+
+  co_return co_await async.waitStatus(STATUS_WORD_SETPOINT_TOL_FLAG, STATUS_WORD_SETPOINT_TOL_IN_RANGE, index, 20000);
+}
+
+USSTask sequence(G110 &drive, const int index, const float freq)
+{
+  if(co_await async.setParameter(PARAM_NR_ROUNDING_TIME_S, 1.0f, index) != 0)
+    co_return -1;
+
+  drive.setFrequency(freq);
+  drive.setON();
+
+  if(co_await async.waitStatus(STATUS_WORD_SETPOINT_TOL_FLAG, STATUS_WORD_SETPOINT_TOL_IN_RANGE, index, 20000) != 0)
+  {
+    printf("drive %d didn't reach %.1f Hz\n", index, freq);
+    drive.setOFF1();
+    co_return -1;
+  }
+
+  co_await async.sleep(2000);
+
+  if(co_await reverse(drive, index, -freq) != 0)
+    printf("drive %d didn't reach %.1f Hz\n", index, -freq);
+
+  co_await async.sleep(2000);
+
+  drive.setOFF1();
+
+  if(co_await async.waitStatus(STATUS_WORD_OP_ENABLED_FLAG, STATUS_WORD_OP_ENABLED_INHIBIT, index, 20000) != 0)
+    co_return -1;
+
+  printf("drive %d stopped\n", index);
+
+  co_return 0;
+}
+
+int main()
+{
+  const char slaves[NR_SLAVES] = { 0x1, 0x2 };
+
+  quickCommissioning_t motor_data;
+  motor_data.powerSetting = POWER_SETTING_EUROPE;
+  motor_data.motorVoltage = 230;
+  motor_data.motorCurrent = 1.9f;
+  motor_data.motorPower = 0.37f;
+  motor_data.motorCosPhi = 0.74f;
+  motor_data.motorFreq = 50.0f;
+  motor_data.motorSpeed = 1390;
+  motor_data.motorCooling = MOTOR_COOLING_SELF_COOLED;
+  motor_data.motorOverload = 150.0f;
+  motor_data.cmdSource = COMMAND_SOURCE_USS;
+  motor_data.setpointSource = FREQ_SETPOINT_USS;
+  motor_data.minFreq = 0.0f;
+  motor_data.maxFreq = 100.0f;
+  motor_data.rampupTime = 4.0f;
+  motor_data.rampdownTime = 4.0f;
+  motor_data.OFF3rampdownTime = 3.0f;
+  motor_data.ctlMode = CTL_MODE_V_F_LINEAR;
+  motor_data.endQuickComm = END_QUICK_COMM_ONLY_MOTOR_DATA;
+
+  if(uss.begin("/dev/ttyS0", 38400, slaves, NR_SLAVES, DE_PIN) != 0)
+    return -1;
+
+  g110Commissioning_t commissioning[NR_SLAVES] = {{&drives[0], &motor_data, 0, 0}, {&drives[1], &motor_data, 1, 0}};
+
+  if(G110::beginAll(&uss, commissioning, NR_SLAVES) != 0)
+    return -1;
+
+  // the bus master thread finishes the jobs and watches the sequences wait for
+  uss.startCyclic();
+
+  // no thread per drive, the main thread sleeps until the bus cycle finished a job or a watch
+  async.spawn(sequence(drives[0], 0, 30.0f));
+  async.spawn(sequence(drives[1], 1, 20.0f));
+
+  return async.run();
+}
@@ -66,8 +66,9 @@ int main()
   sleep(2);
 
 //  left.reset();
-  left.begin(&uss, motor_data, 0);
-  right.begin(&uss, motor_data, 1);
+  // both drives are commissioned in parallel, instead of left.begin(&uss, motor_data, 0) and then right
+  g110Commissioning_t drives[NR_SLAVES] = {{&left, &motor_data, 0, 0}, {&right, &motor_data, 1, 0}};
+  G110::beginAll(&uss, drives, NR_SLAVES);
 
   left.setParameter(PARAM_NR_PULSE_FREQ_KHZ, (unsigned short) 16);
   left.setParameter(PARAM_NR_ROUNDING_TIME_S, 1.0f);
@@ -81,20 +82,19 @@ int main()
   right.setFrequency(35.0f);
   right.setON();
 
+  // reverse for 2 s, then OFF1 for 2 s, run by the bus cycle every 4 s, so the timing doesn't depend on
+  // the scheduling of this thread
+  g110ProfilePoint_t leftProfile[2] = {{0, -30.0f, CTL_WORD_ON_OFF1_ON, 0}, {2000, -30.0f, 0, CTL_WORD_ON_OFF1_FLAG}};
+  g110ProfilePoint_t rightProfile[2] = {{0, -35.0f, CTL_WORD_ON_OFF1_ON, 0}, {2000, -35.0f, 0, CTL_WORD_ON_OFF1_FLAG}};
+
+  // from here the bus master thread runs the cyclic exchange, sleep() in the loop does not stop the bus
+  uss.startCyclic();
+
+  left.startProfile(leftProfile, 2, 4000);
+  right.startProfile(rightProfile, 2, 4000);
+
   while(1)
   {
-	  uss.send();
-	//  Serial.print("receive: ");
-	  uss.receive();
-	  left.setFrequency(-30.0f);
-	  right.setFrequency(-35.0f);
-	  sleep(2);
-	  left.setOFF1();
-	  right.setOFF1();
-	  sleep(2);
+	  sleep(10);
   }
 }
-
-
-
-
@@ -0,0 +1,102 @@
+/**
+ * copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   multi_bus_control.cpp
+ *   @brief  example for SINAMICS G110 Raspberry Pi library with two USS buses,
+ *           the UART on the GPIO header and a RS485/USB module, each bus runs
+ *           in its own thread on its own CPU core
+ *   @date   17.10.2026
+ */
+
+#include <G110.h>
+#include <USS.h>
+#include <USSBusManager.h>
+#include <USSTransport.h>
+
+#define DE_PIN 5
+#define NR_SLAVES 2
+
+USSTermiosTransport usbTransport;    // RS485/USB module switches direction on its own, must outlive usbBus
+USS uartBus;
+USS usbBus;
+USSBusManager buses;
+
+G110 drives[2 * NR_SLAVES];
+
+int main()
+{
+  const char slaves[NR_SLAVES] = { 0x1, 0x2 };
+
+  quickCommissioning_t motor_data;
+  motor_data.powerSetting = POWER_SETTING_EUROPE;
+  motor_data.motorVoltage = 230;
+  motor_data.motorCurrent = 1.9f;
+  motor_data.motorPower = 0.37f;
+  motor_data.motorCosPhi = 0.74f;
+  motor_data.motorFreq = 50.0f;
+  motor_data.motorSpeed = 1390;
+  motor_data.motorCooling = MOTOR_COOLING_SELF_COOLED;
+  motor_data.motorOverload = 150.0f;
+  motor_data.cmdSource = COMMAND_SOURCE_USS;
+  motor_data.setpointSource = FREQ_SETPOINT_USS;
+  motor_data.minFreq = 0.0f;
+  motor_data.maxFreq = 100.0f;
+  motor_data.rampupTime = 4.0f;
+  motor_data.rampdownTime = 4.0f;
+  motor_data.OFF3rampdownTime = 3.0f;
+  motor_data.ctlMode = CTL_MODE_V_F_LINEAR;
+  motor_data.endQuickComm = END_QUICK_COMM_ONLY_MOTOR_DATA;
+
+  // the RS485/USB module switches direction on its own, so it needs no driver enable pin
+  if(uartBus.begin("/dev/ttyS0", 38400, slaves, NR_SLAVES, DE_PIN) != 0 ||
+     usbBus.begin(&usbTransport, "/dev/ttyUSB0", 38400, slaves, NR_SLAVES) != 0)
+    return -1;
+
+  buses.add(&uartBus, 2);
+  buses.add(&usbBus, 3);
+
+  // with the bus threads running, commissioning the drives of one bus doesn't stop the telegrams on the other
+  buses.startAll();
+
+  g110Commissioning_t uartDrives[NR_SLAVES] = {{&drives[0], &motor_data, 0, 0}, {&drives[1], &motor_data, 1, 0}};
+  g110Commissioning_t usbDrives[NR_SLAVES] = {{&drives[2], &motor_data, 0, 0}, {&drives[3], &motor_data, 1, 0}};
+
+  G110::beginAll(&uartBus, uartDrives, NR_SLAVES);
+  G110::beginAll(&usbBus, usbDrives, NR_SLAVES);
+
+  for(int i = 0; i < 2 * NR_SLAVES; i++)
+  {
+    drives[i].setFrequency(10.0f * (i + 1));
+    drives[i].setON();
+  }
+
+  float direction = 1.0f;
+
+  while(1)
+  {
+    sleep(10);
+    direction *= -1.0f;
+
+    for(int i = 0; i < 2 * NR_SLAVES; i++)
+      drives[i].setFrequency(direction * 10.0f * (i + 1));
+  }
+}
@@ -0,0 +1,132 @@
+/**
+ * copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   parameter_backup.cpp
+ *   @brief  example for saving the parameters of a G110 into a parameter image
+ *           and restoring them to a replaced drive,
+ *           "parameter_backup save g110.img" and "parameter_backup restore g110.img",
+ *           a third argument runs it on a serial device without DE pin, e.g. the emulator
+ *   @date   17.10.2026
+ */
+
+#include <G110.h>
+#include <USS.h>
+#include <USSParamImage.h>
+#include <USSTransport.h>
+#include <stdio.h>
+
+#define DE_PIN 5
+#define NR_SLAVES 1
+
+USS uss;
+USSTermiosTransport transport;
+
+int save(const char *path)
+{
+  USSParamImage image;
+
+  if(image.create(path, 64) != 0)
+    return -1;
+
+  // the access level first, the drive checks it before the parameters that need it
+  image.add(PARAM_NR_USER_ACCESS_LEVEL, 0, USS_PARAM_TYPE_WORD);
+  image.add(PARAM_NR_MOTOR_VOLTAGE_V, 0, USS_PARAM_TYPE_WORD);
+  image.addRange(PARAM_NR_MOTOR_CURRENT_A, PARAM_NR_MOTOR_POWER_KW_HP, 1, USS_PARAM_TYPE_FLOAT);
+  image.add(PARAM_NR_MOTOR_COS_PHI, 0, USS_PARAM_TYPE_FLOAT);
+  image.add(PARAM_NR_MOTOR_FREQ_HZ, 0, USS_PARAM_TYPE_FLOAT);
+  image.add(PARAM_NR_MOTOR_SPEED_PER_MINUTE, 0, USS_PARAM_TYPE_WORD);
+  image.add(PARAM_NR_SEL_CMD_SOURCE, 0, USS_PARAM_TYPE_WORD);
+  image.add(PARAM_NR_SEL_FREQ_SETPOINT, 0, USS_PARAM_TYPE_WORD);
+  image.addRange(PARAM_NR_MIN_FREQ_HZ, PARAM_NR_MAX_FREQ_HZ, 1, USS_PARAM_TYPE_FLOAT);
+  image.addRange(PARAM_NR_RAMP_UP_TIME_S, PARAM_NR_OFF3_RAMP_DOWN_TIME_S, 1, USS_PARAM_TYPE_FLOAT);
+  image.add(PARAM_NR_PULSE_FREQ_KHZ, 0, USS_PARAM_TYPE_WORD);
+  image.addRange(PARAM_NR_USS_PZD_ACTUAL_VALUES, PARAM_NR_USS_PZD_ACTUAL_VALUES, 4, USS_PARAM_TYPE_WORD);
+
+  int failed = image.readDrive(&uss, 0);
+
+  // numbers in the ranges the drive doesn't have, like P1122 to P1129
+  failed -= image.removeMissing();
+
+  printf("saved %u parameters, %d failed\n", image.count(), failed);
+
+  return failed;
+}
+
+int restore(const char *path)
+{
+  USSParamImage image;
+  unsigned int written;
+
+  if(image.open(path) != 0)
+    return -1;
+
+  // the motor data P0304 to P0311 can only be changed in quick commissioning, like in G110::begin()
+  if(uss.setParameter(PARAM_NR_COMMISSIONING_PARAM, QUICK_COMMISSIONING_QUICK_COMM, 0) != 0)
+    return -1;
+
+  int failed = image.writeDrive(&uss, 0, written);
+
+  // the drive can't be switched on before it is back from quick commissioning
+  if(uss.setParameter(PARAM_NR_COMMISSIONING_PARAM, QUICK_COMMISSIONING_READY, 0) != 0)
+    failed++;
+
+  printf("%u of %u parameters written, %d failed\n", written, image.count(), failed);
+
+  for(unsigned int i = 0; i < image.count(); i++)
+  {
+    if(image.entry(i)->result != 0)
+      printf("P%u[%u]: error %d\n", image.entry(i)->param, image.entry(i)->index, image.entry(i)->result);
+  }
+
+  return failed;
+}
+
+int main(int argc, char *argv[])
+{
+  const char slaves[NR_SLAVES] = { 0x1 };
+
+  if(argc != 3 && argc != 4)
+  {
+    printf("usage: %s save|restore image [tty]\n", argv[0]);
+    return -1;
+  }
+
+  if(argc == 4)
+  {
+    if(uss.begin(&transport, argv[3], 38400, slaves, NR_SLAVES) != 0)
+      return -1;
+  }
+  else if(uss.begin("/dev/ttyS0", 38400, slaves, NR_SLAVES, DE_PIN) != 0)
+  {
+    return -1;
+  }
+
+  uss.startCyclic();
+
+  // expert access, so all parameters can be read
+  uss.setParameter(PARAM_NR_USER_ACCESS_LEVEL, USER_ACCESS_LEVEL_EXPERT, 0);
+
+  if(argv[1][0] == 's')
+    return save(argv[2]);
+
+  return restore(argv[2]);
+}
@@ -36,79 +36,238 @@
 G110::G110() :
     m_interface(nullptr),
     m_refFreq(0.0),
+    m_refCurrent(0.0),
     m_index(0)
 {
 }
 
 int G110::begin(USS *interface, const quickCommissioning_t &quickCommData, const int index)
 {
-    if(interface == nullptr)
-        return -1;
+    g110Commissioning_t drive = {this, &quickCommData, index, 0};
+
+    return beginAll(interface, &drive, 1);
+}
 
-    m_interface = interface;
-    m_refFreq = quickCommData.motorFreq;
-    m_index = index;
+int G110::beginAll(USS *interface, g110Commissioning_t drives[], const int nrDrives)
+{
     int err = 0;
+    int queueErr[USS_SLAVES] = {0};
+
+    // every drive is a slave of its own on the interface
+    if(interface == nullptr || drives == nullptr || nrDrives > USS_SLAVES)
+        return -1;
+
+    for(int i = 0; i < nrDrives; i++)
+    {
+        G110 *drive = drives[i].drive;
+
+        drives[i].err = 0;
+
+        if(drive == nullptr || drives[i].quickCommData == nullptr)
+        {
+            drives[i].err = -1;
+            continue;
+        }
+
+        drive->m_interface = interface;
+        drive->m_refFreq = drives[i].quickCommData->motorFreq;
+        drive->m_refCurrent = drives[i].quickCommData->motorCurrent;
+        drive->m_index = drives[i].index;
+
+        // the jobs of all drives are queued first, the bus then sends them interleaved in the cyclic telegrams
+        if(USS_PKW_WORDS > 0)
+            queueErr[i] = drive->queueCommissioning(*drives[i].quickCommData, &drives[i].err);
+    }
+
+    interface->flushParameters();
+
+    for(int i = 0; i < nrDrives; i++)
+    {
+        drives[i].err += queueErr[i];
+
+        if(!drives[i].err)
+            drives[i].drive->setCtlFlag(CTL_WORD_ENABLE_ENABLE | CTL_WORD_INHIBIT_RAMP_OP_COND |
+                                        CTL_WORD_ENABLE_RAMP_ENABLE | CTL_WORD_ENABLE_SETPOINT_ENABLE |
+                                        CTL_WORD_CTL_PLC_CTL_PLC);
+
+        err += drives[i].err;
+    }
+
+    return err;
+}
+
+int G110::queueCommissioning(const quickCommissioning_t &quickCommData, int *err) const
+{
+    int ret = 0;
 
-    err += setParameter(PARAM_NR_USER_ACCESS_LEVEL, USER_ACCESS_LEVEL_EXPERT);
-    err += setParameter(PARAM_NR_USS_PKW_LENGTH, USS_PKW_LENGTH_4_WORDS);
-    err += setParameter(PARAM_NR_COMMISSIONING_PARAM, QUICK_COMMISSIONING_QUICK_COMM);
-    err += setParameter(PARAM_NR_POWER_SETING, quickCommData.powerSetting);
-    err += setParameter(PARAM_NR_MOTOR_VOLTAGE_V, quickCommData.motorVoltage);
-    err += setParameter(PARAM_NR_MOTOR_CURRENT_A, quickCommData.motorCurrent);
-    err += setParameter(PARAM_NR_MOTOR_POWER_KW_HP, quickCommData.motorPower);
+    ret += queueParameter(PARAM_NR_USER_ACCESS_LEVEL, USER_ACCESS_LEVEL_EXPERT, err);
+    ret += queueParameter(PARAM_NR_USS_PKW_LENGTH, (uint16_t)USS_PKW_WORDS, err);
+    ret += queueParameter(PARAM_NR_USS_PZD_LENGTH, (uint16_t)USS_PZD_WORDS, err);
+    ret += queueParameter(PARAM_NR_COMMISSIONING_PARAM, QUICK_COMMISSIONING_QUICK_COMM, err);
+    ret += queueParameter(PARAM_NR_POWER_SETING, quickCommData.powerSetting, err);
+    ret += queueParameter(PARAM_NR_MOTOR_VOLTAGE_V, quickCommData.motorVoltage, err);
+    ret += queueParameter(PARAM_NR_MOTOR_CURRENT_A, quickCommData.motorCurrent, err);
+    ret += queueParameter(PARAM_NR_MOTOR_POWER_KW_HP, quickCommData.motorPower, err);
 
     if(quickCommData.powerSetting == POWER_SETTING_NORTH_AMERICA_HP)
-        err += setParameter(PARAM_NR_MOTOR_EFFICIENCY_FACTOR, quickCommData.motorEff);
+        ret += queueParameter(PARAM_NR_MOTOR_EFFICIENCY_FACTOR, quickCommData.motorEff, err);
     else
-        err += setParameter(PARAM_NR_MOTOR_COS_PHI, quickCommData.motorCosPhi);
-
-    err += setParameter(PARAM_NR_MOTOR_FREQ_HZ, quickCommData.motorFreq);
-    err += setParameter(PARAM_NR_MOTOR_SPEED_PER_MINUTE, quickCommData.motorSpeed);
-    err += setParameter(PARAM_NR_MOTOR_COOLING, quickCommData.motorCooling);
-    err += setParameter(PARAM_NR_MOTOR_OVERLOAD_FACTOR, quickCommData.motorOverload);
-    err += setParameter(PARAM_NR_SEL_CMD_SOURCE, quickCommData.cmdSource);
-    err += setParameter(PARAM_NR_SEL_FREQ_SETPOINT, quickCommData.setpointSource);
-    err += setParameter(PARAM_NR_MIN_FREQ_HZ, quickCommData.minFreq);
-    err += setParameter(PARAM_NR_MAX_FREQ_HZ, quickCommData.maxFreq);
-    err += setParameter(PARAM_NR_RAMP_UP_TIME_S, quickCommData.rampupTime);
-    err += setParameter(PARAM_NR_RAMP_DOWN_TIME_S, quickCommData.rampdownTime);
-    err += setParameter(PARAM_NR_OFF3_RAMP_DOWN_TIME_S, quickCommData.OFF3rampdownTime);
-    err += setParameter(PARAM_NR_CTL_MODE, quickCommData.ctlMode);
-    err += setParameter(PARAM_NR_COMMISSIONING_PARAM, QUICK_COMMISSIONING_READY);
-    err += setParameter(PARAM_NR_CALC_MOTOR_PARAMS, CALC_MOTOR_PARAMS_COMPLETE);
-
-    if(!err)
-        setCtlFlag(CTL_WORD_ENABLE_ENABLE | CTL_WORD_INHIBIT_RAMP_OP_COND |
-                              CTL_WORD_ENABLE_RAMP_ENABLE | CTL_WORD_ENABLE_SETPOINT_ENABLE |
-                              CTL_WORD_CTL_PLC_CTL_PLC);
+        ret += queueParameter(PARAM_NR_MOTOR_COS_PHI, quickCommData.motorCosPhi, err);
+
+    ret += queueParameter(PARAM_NR_MOTOR_FREQ_HZ, quickCommData.motorFreq, err);
+    ret += queueParameter(PARAM_NR_MOTOR_SPEED_PER_MINUTE, quickCommData.motorSpeed, err);
+    ret += queueParameter(PARAM_NR_MOTOR_COOLING, quickCommData.motorCooling, err);
+    ret += queueParameter(PARAM_NR_MOTOR_OVERLOAD_FACTOR, quickCommData.motorOverload, err);
+    ret += queueParameter(PARAM_NR_SEL_CMD_SOURCE, quickCommData.cmdSource, err);
+    ret += queueParameter(PARAM_NR_SEL_FREQ_SETPOINT, quickCommData.setpointSource, err);
+    ret += queueParameter(PARAM_NR_MIN_FREQ_HZ, quickCommData.minFreq, err);
+    ret += queueParameter(PARAM_NR_MAX_FREQ_HZ, quickCommData.maxFreq, err);
+    ret += queueParameter(PARAM_NR_RAMP_UP_TIME_S, quickCommData.rampupTime, err);
+    ret += queueParameter(PARAM_NR_RAMP_DOWN_TIME_S, quickCommData.rampdownTime, err);
+    ret += queueParameter(PARAM_NR_OFF3_RAMP_DOWN_TIME_S, quickCommData.OFF3rampdownTime, err);
+    ret += queueParameter(PARAM_NR_CTL_MODE, quickCommData.ctlMode, err);
+    ret += queueParameter(PARAM_NR_COMMISSIONING_PARAM, QUICK_COMMISSIONING_READY, err);
+    ret += queueParameter(PARAM_NR_CALC_MOTOR_PARAMS, CALC_MOTOR_PARAMS_COMPLETE, err);
+
+    // actual values in the PZD words are scaled to the reference values, so they are set to what the
+    // conversions of this class use
+    ret += queueParameter(PARAM_NR_REF_FREQ_HZ, quickCommData.motorFreq, err);
+    ret += queueParameter(PARAM_NR_REF_CURRENT_A, quickCommData.motorCurrent, err);
+
+    // current and DC-link voltage are sent in the additional PZD words, when the telegram has them
+    if(USS_PZD_WORDS >= G110_PZD_OUTPUT_CURRENT)
+        ret += m_interface->setParameterIndexAsync(PARAM_NR_USS_PZD_ACTUAL_VALUES, G110_PZD_OUTPUT_CURRENT - 1,
+                                                   USS_PZD_ACTUAL_OUTPUT_CURRENT, m_index, commissioningCallback, err,
+                                                   jobTimeoutMs());
+
+    if(USS_PZD_WORDS >= G110_PZD_DC_LINK_VOLTAGE)
+        ret += m_interface->setParameterIndexAsync(PARAM_NR_USS_PZD_ACTUAL_VALUES, G110_PZD_DC_LINK_VOLTAGE - 1,
+                                                   USS_PZD_ACTUAL_DC_LINK_VOLTAGE, m_index, commissioningCallback, err,
+                                                   jobTimeoutMs());
+
+    return ret;
+}
 
-    return err;
+int G110::queueParameter(const uint16_t param, const uint16_t value, int *err) const
+{
+    return m_interface->setParameterAsync(param, value, m_index, commissioningCallback, err, jobTimeoutMs());
 }
 
+int G110::queueParameter(const uint16_t param, const float value, int *err) const
+{
+    return m_interface->setParameterAsync(param, value, m_index, commissioningCallback, err, jobTimeoutMs());
+}
+
+int G110::jobTimeoutMs() const
+{
+    ussCycleStats_t stats;
+
+    // the spec period of begin() is the longest a bus cycle takes, every slave of the interface gets one per round
+    m_interface->getCycleStats(stats);
+
+    return USS_PKW_TIMEOUT_MS + (int)((long long)m_interface->pendingParameters(m_index) * m_interface->nrSlaves() *
+                                      G110_TELEGRAMS_PER_JOB * stats.period / 1000);
+}
+
+void G110::commissioningCallback(const int result, const uint16_t param, const uint32_t value, void *context)
+{
+    (void)param;
+    (void)value;
+
+    *static_cast<int *>(context) += result;
+}
 
 void G110::setFrequency(float freq) const
 {
-    bool reverse = false;
+    uint16_t f_hex;
+    uint16_t setFlags;
+    uint16_t clearFlags;
 
     if(m_interface == nullptr)
         return;
 
+    frequencyToSetpoint(freq, f_hex, setFlags, clearFlags);
+
+    // direction and setpoint are updated together, so the bus never sends the new direction with the old setpoint
+    m_interface->setOutputs(setFlags, clearFlags, f_hex, m_index);
+}
+
+void G110::frequencyToSetpoint(float freq, uint16_t &mainsetpoint, uint16_t &setFlags, uint16_t &clearFlags) const
+{
+    bool reverse = false;
+
     if(freq < 0)
     {
         reverse = true;
         freq *= -1.0f;
     }
     // f[Hz] = (f(hex) / FREQUENCY_CALC_BASE) * refFreq
-    uint16_t f_hex = (freq / m_refFreq) * FREQUENCY_CALC_BASE;
+    mainsetpoint = (freq / m_refFreq) * FREQUENCY_CALC_BASE;
+    setFlags = reverse ? CTL_WORD_REVERSE_FALG : 0;
+    clearFlags = reverse ? 0 : CTL_WORD_REVERSE_FALG;
+}
 
-    if(reverse)
-        setCtlFlag(CTL_WORD_REVERSE_FALG);
-    else
-        clearCtlFlag(CTL_WORD_REVERSE_FALG);
+int G110::startProfile(const g110ProfilePoint_t profile[], const int nrPoints, const unsigned long periodMs) const
+{
+    ussTrajectoryPoint_t points[USS_TRAJECTORY_LENGTH];
+
+    if(m_interface == nullptr || profile == nullptr || nrPoints < 1 || nrPoints > USS_TRAJECTORY_LENGTH)
+        return -1;
+
+    // the conversion is done here once, the bus cycle only copies the words
+    for(int i = 0; i < nrPoints; i++)
+    {
+        uint16_t setFlags;
+        uint16_t clearFlags;
+
+        frequencyToSetpoint(profile[i].freq, points[i].mainsetpoint, setFlags, clearFlags);
+        points[i].timeMs = profile[i].timeMs;
+        points[i].setFlags = profile[i].setFlags | setFlags;
+        points[i].clearFlags = (profile[i].clearFlags | clearFlags) & ~points[i].setFlags;
+    }
+
+    return m_interface->startTrajectory(points, nrPoints, m_index, periodMs);
+}
+
+void G110::stopProfile() const
+{
+    if(m_interface == nullptr)
+        return;
+
+    m_interface->stopTrajectory(m_index);
+}
+
+bool G110::profileRunning() const
+{
+    if(m_interface == nullptr)
+        return false;
 
-    m_interface->setMainsetpoint(f_hex, m_index);
+    return m_interface->trajectoryRunning(m_index);
+}
 
+int G110::addRamp(g110ProfilePoint_t profile[], const int nrPoints, const int maxPoints, const uint32_t startMs,
+                  const uint32_t durationMs, const float fromFreq, const float toFreq, const int steps,
+                  const bool sCurve)
+{
+    if(profile == nullptr || steps < 1 || nrPoints < 0 || nrPoints + steps > maxPoints)
+        return -1;
+
+    for(int i = 1; i <= steps; i++)
+    {
+        g110ProfilePoint_t &point = profile[nrPoints + i - 1];
+        float x = (float)i / steps;
+
+        // S-curve with zero slope at start and end (smoothstep)
+        if(sCurve)
+            x = x * x * (3.0f - 2.0f * x);
+
+        point.timeMs = startMs + (uint32_t)((unsigned long long)durationMs * i / steps);
+        point.freq = fromFreq + (toFreq - fromFreq) * x;
+        point.setFlags = 0;
+        point.clearFlags = 0;
+    }
+
+    return nrPoints + steps;
 }
 
 void G110::setON() const
@@ -178,7 +337,54 @@ float G110::getFrequency() const
 
     uint16_t f_hex = m_interface->getActualvalue(m_index);
     // f[Hz] = (f(hex) / FREQUENCY_CALC_BASE) * refFreq
-    return (f_hex / FREQUENCY_CALC_BASE) * m_refFreq;
+    return ((float)f_hex / FREQUENCY_CALC_BASE) * m_refFreq;
+}
+
+float G110::getCurrent() const
+{
+    g110ActualValues_t values;
+
+    if(getActualValues(values) != 0)
+        return -1.0;
+
+    return values.current;
+}
+
+float G110::getDCLinkVoltage() const
+{
+    g110ActualValues_t values;
+
+    if(getActualValues(values) != 0)
+        return -1.0;
+
+    return values.dcLinkVoltage;
+}
+
+int G110::getActualValues(g110ActualValues_t &values) const
+{
+    uint16_t pzd[USS_PZD_WORDS];
+
+    if(m_interface == nullptr || m_interface->getInputs(pzd, m_index) != 0)
+        return -1;
+
+    decodeActualValues(pzd, values);
+
+    return 0;
+}
+
+void G110::decodeActualValues(const uint16_t pzd[], g110ActualValues_t &values) const
+{
+    values.statusword = pzd[0];
+    // x = (x(hex) / FREQUENCY_CALC_BASE) * reference value, the same base is used for all actual values
+    values.frequency = ((float)pzd[1] / FREQUENCY_CALC_BASE) * m_refFreq;
+    values.current = -1.0;
+    values.dcLinkVoltage = -1.0;
+
+    if(USS_PZD_WORDS >= G110_PZD_OUTPUT_CURRENT)
+        values.current = ((float)pzd[G110_PZD_OUTPUT_CURRENT - 1] / FREQUENCY_CALC_BASE) * m_refCurrent;
+
+    if(USS_PZD_WORDS >= G110_PZD_DC_LINK_VOLTAGE)
+        values.dcLinkVoltage = ((float)pzd[G110_PZD_DC_LINK_VOLTAGE - 1] / FREQUENCY_CALC_BASE) * REF_VOLTAGE_V;
 }
 
 void G110::reset() const
@@ -211,3 +417,115 @@ int G110::setParameter(const uint16_t param, const float value) const
 
     return m_interface->setParameter(param, value, m_index);
 }
+
+int G110::getParameter(const uint16_t param, uint16_t &value, const uint16_t index, const int maxAgeMs) const
+{
+    if(m_interface == nullptr)
+        return -1;
+
+    return m_interface->getParameter(param, value, m_index, index, maxAgeMs);
+}
+
+int G110::getParameter(const uint16_t param, uint32_t &value, const uint16_t index, const int maxAgeMs) const
+{
+    if(m_interface == nullptr)
+        return -1;
+
+    return m_interface->getParameter(param, value, m_index, index, maxAgeMs);
+}
+
+int G110::getParameter(const uint16_t param, float &value, const uint16_t index, const int maxAgeMs) const
+{
+    if(m_interface == nullptr)
+        return -1;
+
+    return m_interface->getParameter(param, value, m_index, index, maxAgeMs);
+}
+
+G110Group::G110Group() :
+    m_drives{nullptr},
+    m_nrDrives(0),
+    m_ctlword(CTL_WORD_ENABLE_ENABLE | CTL_WORD_INHIBIT_RAMP_OP_COND | CTL_WORD_ENABLE_RAMP_ENABLE |
+              CTL_WORD_ENABLE_SETPOINT_ENABLE | CTL_WORD_CTL_PLC_CTL_PLC),
+    m_mainsetpoint(0)
+{
+}
+
+int G110Group::add(G110 *drive)
+{
+    if(drive == nullptr || drive->m_interface == nullptr || m_nrDrives == USS_SLAVES)
+        return -1;
+
+    // one setpoint word for all drives is only the same frequency with the same reference
+    if(m_nrDrives > 0 &&
+       (drive->m_interface != m_drives[0]->m_interface || drive->m_refFreq != m_drives[0]->m_refFreq))
+        return -1;
+
+    for(int i = 0; i < m_nrDrives; i++)
+    {
+        if(m_drives[i]->m_index == drive->m_index)
+            return -1;
+    }
+
+    m_drives[m_nrDrives++] = drive;
+
+    return 0;
+}
+
+int G110Group::setFrequency(float freq)
+{
+    if(!complete())
+        return -1;
+
+    if(freq < 0)
+    {
+        m_ctlword |= CTL_WORD_REVERSE_FALG;
+        freq *= -1.0f;
+    }
+    else
+    {
+        m_ctlword &= ~CTL_WORD_REVERSE_FALG;
+    }
+
+    // f[Hz] = (f(hex) / FREQUENCY_CALC_BASE) * refFreq
+    m_mainsetpoint = (freq / m_drives[0]->m_refFreq) * FREQUENCY_CALC_BASE;
+
+    return m_drives[0]->m_interface->broadcast(m_ctlword, m_mainsetpoint);
+}
+
+int G110Group::setON()
+{
+    return setCtlFlag(CTL_WORD_ON_OFF1_ON | CTL_WORD_OFF2_OP_COND | CTL_WORD_OFF3_OP_COND);
+}
+
+int G110Group::setOFF1()
+{
+    return clearCtlFlag(CTL_WORD_ON_OFF1_FLAG);
+}
+
+int G110Group::setCtlFlag(const uint16_t flags)
+{
+    if(!complete())
+        return -1;
+
+    m_ctlword |= flags;
+
+    return m_drives[0]->m_interface->broadcast(m_ctlword, m_mainsetpoint);
+}
+
+int G110Group::clearCtlFlag(const uint16_t flags)
+{
+    if(!complete())
+        return -1;
+
+    m_ctlword &= ~flags;
+
+    return m_drives[0]->m_interface->broadcast(m_ctlword, m_mainsetpoint);
+}
+
+bool G110Group::complete() const
+{
+    // the broadcast sets the outputs of every slave, drives the group doesn't know would be switched with it,
+    // and the additional setpoints of all of them when the telegram has additional PZD words
+    return USS_PZD_ADD_WORDS == 0 && m_nrDrives > 0 && m_nrDrives == m_drives[0]->m_interface->nrSlaves();
+}
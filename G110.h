@@ -170,9 +170,14 @@
  * Parameter numbers
  */
 #define PARAM_NR_END_QUICK_COMM             3900
+#define PARAM_NR_USS_PZD_ACTUAL_VALUES      2019
 #define PARAM_NR_USS_PKW_LENGTH             2013
+#define PARAM_NR_USS_PZD_LENGTH             2012
 #define PARAM_NR_USS_ADDRESS                2011
 #define PARAM_NR_USS_BAUDRATE               2010
+#define PARAM_NR_REF_CURRENT_A              2002
+#define PARAM_NR_REF_VOLTAGE_V              2001
+#define PARAM_NR_REF_FREQ_HZ                2000
 #define PARAM_NR_PULSE_FREQ_KHZ             1800
 #define PARAM_NR_CTL_MODE                   1300
 #define PARAM_NR_OFF3_RAMP_DOWN_TIME_S      1135
@@ -202,11 +207,38 @@
 #define PARAM_NR_COMMISSIONING_PARAM        10
 #define PARAM_NR_USER_ACCESS_LEVEL          3
 
+/**
+ * Parameter values actual values sent in the PZD words (P2019, index 0 to 3 for PZD1 to PZD4)
+ */
+#define USS_PZD_ACTUAL_STATUS_WORD          (uint16_t)52
+#define USS_PZD_ACTUAL_FREQ                 (uint16_t)21
+#define USS_PZD_ACTUAL_OUTPUT_VOLTAGE       (uint16_t)25
+#define USS_PZD_ACTUAL_DC_LINK_VOLTAGE      (uint16_t)26
+#define USS_PZD_ACTUAL_OUTPUT_CURRENT       (uint16_t)27
+
+/**
+ * PZD words of the additional actual values decoded by the G110 class, begin() sets P2019 so the inverter sends
+ * output current and DC-link voltage in them when USS_PZD_WORDS is large enough
+ */
+#define G110_PZD_OUTPUT_CURRENT             3
+#define G110_PZD_DC_LINK_VOLTAGE            4
+
+/**
+ * Telegrams to the drive a commissioning job may take: the job, the old response the drive repeats until it
+ * has processed it, its response and a telegram without job between two jobs on the same parameter
+ */
+#define G110_TELEGRAMS_PER_JOB              4
+
 /**
  * Number used in calculation of main setpoint from given frequency in Hz as floating point
  */
 #define FREQUENCY_CALC_BASE                 0x4000
 
+/**
+ * Reference voltage for actual values in V, factory setting of P2001, 0x4000 in a PZD word is this voltage
+ */
+#define REF_VOLTAGE_V                       1000
+
 // custom data types
 typedef unsigned char byte;
 typedef unsigned char uint8_t;
@@ -239,6 +271,41 @@ typedef struct
     uint16_t endQuickComm;
 } quickCommissioning_t;
 
+/**
+ * @struct structure definition for the actual values of one G110 response
+ */
+typedef struct
+{
+    uint16_t statusword;
+    float frequency;                // Hz, always positive, reverse() gives the direction
+    float current;                  // output current in A, -1.0 without PZD word
+    float dcLinkVoltage;            // V, -1.0 without PZD word
+} g110ActualValues_t;
+
+/**
+ * @struct structure definition for one point of a frequency profile run by the bus cycle
+ */
+typedef struct
+{
+    uint32_t timeMs;                // time of the point from the start of the profile
+    float freq;                     // frequency in Hz, negative for reverse
+    uint16_t setFlags;              // control word flags set at this point, like for setCtlFlag()
+    uint16_t clearFlags;            // control word flags cleared at this point, like for clearCtlFlag()
+} g110ProfilePoint_t;
+
+class G110;
+
+/**
+ * @struct structure definition for one drive commissioned with G110::beginAll()
+ */
+typedef struct
+{
+    G110 *drive;
+    const quickCommissioning_t *quickCommData;
+    int index;                      // index in array of USS slave addresses used on creation of USS instance
+    int err;                        // result of the commissioning of this drive, set by G110::beginAll()
+} g110Commissioning_t;
+
 class G110
 {
     public:
@@ -259,11 +326,29 @@ class G110
      * @return 0 on success
      *
      * Runs quick commissioning mode with commsioning values given and triggers calculation of
-     * motor parameters. Sets reference frequency for calculation of main setpoint to given motor
-     * frequency. Sets control word to operating conditions.
+     * motor parameters. Sets reference frequency (P2000) for calculation of main setpoint to given motor
+     * frequency and reference current (P2002) for the output current to given motor current. Sets control word
+     * to operating conditions. Without PKW words in the telegram
+     * (USS_PKW_WORDS 0) the inverter must be commissioned before and only the control word is set.
      */
     int begin(USS *interface, const quickCommissioning_t &quickCommData, const int index);
 
+    /**
+     * @brief Configure and commission several G110 on the same USS interface at once
+     *
+     * @param interface instance of USS interface used for communication over serial
+     * @param drives array of drives with their quick commissioning values and slave indices, the result for
+     *               each drive is written to its err member
+     * @param nrDrives number of drives in the array
+     * @return 0 when all drives were commissioned successfully
+     *
+     * Does the same as begin() for every drive, but queues the parameter jobs of all drives before the bus
+     * is run. The jobs of different drives are sent interleaved in the same bus cycles, so the time for
+     * commissioning is given by the slowest drive and not by the sum of all drives. The deadline of a job runs
+     * from queuing, so every job gets USS_PKW_TIMEOUT_MS plus the bus cycles the jobs queued before it may take.
+     */
+    static int beginAll(USS *interface, g110Commissioning_t drives[], const int nrDrives);
+
     /**
      * @brief delay function
      * @param number_of_mseconds is the delay time
@@ -351,6 +436,83 @@ class G110
      */
     float getFrequency() const;
 
+    /**
+     * @brief Start a profile of frequencies and control word flags, applied by the bus cycle
+     *
+     * @param profile points of the profile sorted by time, converted to main setpoints here, so the array can
+     *                be reused at once
+     * @param nrPoints number of points, 1 to USS_TRAJECTORY_LENGTH
+     * @param periodMs time after which the profile starts again, must be after the last point, 0 to run it once
+     * @return 0 on success, -1 on error
+     *
+     * Every point is applied in the bus cycle its time falls in, like setFrequency() and setCtlFlag() called
+     * exactly then, so ramps, S-curves and step sequences run the same way every time without the application
+     * waking up for each step. See USS::startTrajectory().
+     */
+    int startProfile(const g110ProfilePoint_t profile[], const int nrPoints, const unsigned long periodMs = 0) const;
+
+    /**
+     * @brief Stop the profile, the drive keeps the frequency and flags of the last point applied
+     *
+     * @return none
+     */
+    void stopProfile() const;
+
+    /**
+     * @brief Check if the profile is still running
+     *
+     * @return boolean are there points not applied yet?
+     */
+    bool profileRunning() const;
+
+    /**
+     * @brief Append a ramp between two frequencies to a profile
+     *
+     * @param profile array of the profile
+     * @param nrPoints number of points in the profile before the ramp
+     * @param maxPoints size of the array
+     * @param startMs time of the start of the ramp
+     * @param durationMs time from start to end of the ramp
+     * @param fromFreq frequency at the start in Hz
+     * @param toFreq frequency at the end in Hz
+     * @param steps number of points of the ramp, the first at startMs + durationMs / steps
+     * @param sCurve false for a linear ramp, true for an S-curve with smooth start and end
+     * @return number of points in the profile after the ramp, -1 when the array is too small
+     *
+     * The points only change the frequency. With an S-curve the drive should have short ramp times, so the
+     * ramp generator of the drive doesn't flatten it.
+     */
+    static int addRamp(g110ProfilePoint_t profile[], const int nrPoints, const int maxPoints, const uint32_t startMs,
+                       const uint32_t durationMs, const float fromFreq, const float toFreq, const int steps,
+                       const bool sCurve = false);
+
+    /**
+     * @brief Get output current of the inverter from the additional actual value in PZD word
+     *        G110_PZD_OUTPUT_CURRENT
+     *
+     * @return output current in A as floating point number, -1.0 on error or when the telegram has no such word
+     */
+    float getCurrent() const;
+
+    /**
+     * @brief Get DC-link voltage of the inverter from the additional actual value in PZD word
+     *        G110_PZD_DC_LINK_VOLTAGE
+     *
+     * @return DC-link voltage in V as floating point number, -1.0 on error or when the telegram has no such word
+     */
+    float getDCLinkVoltage() const;
+
+    /**
+     * @brief Get status word, frequency, current and DC-link voltage from the same response
+     *
+     * @param values structure the actual values are written to
+     * @return 0 on success, -1 on error
+     *
+     * All values are decoded from the PZD words of the last cyclic telegram, no parameter job is needed. Current
+     * and DC-link voltage are -1.0 when USS_PZD_WORDS is too small for their words.
+     */
+    int getActualValues(g110ActualValues_t &values) const;
+
     /**
      * @brief Reset/restart the inverter over USS
      *
@@ -368,6 +530,8 @@ class G110
      * @retval -1: no response
      * @retval -2: access denied
      * @retval -3: illegal parameter number
+     * @retval -4: corrupted response
+     * @retval >0: error number of the drive, it can't execute the job
      */
     int setParameter(const uint16_t param, const uint16_t value) const;
 
@@ -381,6 +545,8 @@ class G110
      * @retval -1: no response
      * @retval -2: access denied
      * @retval -3: illegal parameter number
+     * @retval -4: corrupted response
+     * @retval >0: error number of the drive, it can't execute the job
      */
     int setParameter(const uint16_t param, const uint32_t value) const;
 
@@ -394,14 +560,176 @@ class G110
      * @retval -1: no response
      * @retval -2: access denied
      * @retval -3: illegal parameter number
+     * @retval -4: corrupted response
+     * @retval >0: error number of the drive, it can't execute the job
      */
     int setParameter(const uint16_t param, const float value) const;
 
+    /**
+     * @brief Get parameter as word value (2 byte) from G110
+     *
+     * @param param parameter number, for parameters refer to G110 user manual
+     * @param value reference the parameter value is written to on success
+     * @param index parameter index for indexed parameters
+     * @param maxAgeMs max age in ms of a cached value to use it, see USS::getParameter()
+     * @return USS error code
+     * @retval 0: success
+     * @retval -1: no response
+     * @retval -2: access denied
+     * @retval -3: illegal parameter number
+     * @retval -4: corrupted response
+     * @retval >0: error number of the drive, it can't execute the job
+     */
+    int getParameter(const uint16_t param, uint16_t &value, const uint16_t index = 0,
+                     const int maxAgeMs = USS_PARAM_CACHE_ANY_AGE) const;
+
+    /**
+     * @brief Get parameter as double word value (4 byte) from G110
+     *
+     * Parameters and return values like getParameter() for word values
+     */
+    int getParameter(const uint16_t param, uint32_t &value, const uint16_t index = 0,
+                     const int maxAgeMs = USS_PARAM_CACHE_ANY_AGE) const;
+
+    /**
+     * @brief Get parameter as float (single precision) from G110
+     *
+     * Parameters and return values like getParameter() for word values
+     */
+    int getParameter(const uint16_t param, float &value, const uint16_t index = 0,
+                     const int maxAgeMs = USS_PARAM_CACHE_ANY_AGE) const;
+
     private:
 
+    /**
+     * @brief Queue the parameter jobs of the quick commissioning for this drive
+     *
+     * @param quickCommData structure of parameter values for quick commissioning
+     * @param err error sum of the finished jobs is added here
+     * @return 0 when all jobs are queued
+     */
+    int queueCommissioning(const quickCommissioning_t &quickCommData, int *err) const;
+
+    /**
+     * @brief Queue one parameter job of the commissioning
+     */
+    int queueParameter(const uint16_t param, const uint16_t value, int *err) const;
+    int queueParameter(const uint16_t param, const float value, int *err) const;
+
+    /**
+     * @brief Get the timeout of the next commissioning job, USS_PKW_TIMEOUT_MS plus G110_TELEGRAMS_PER_JOB
+     *        spec bus cycles over all slaves for every job already queued for this drive
+     */
+    int jobTimeoutMs() const;
+
+    /**
+     * @brief Callback of commissioning jobs, adds the result to the error sum given as context
+     */
+    static void commissioningCallback(const int result, const uint16_t param, const uint32_t value, void *context);
+
+    friend class G110Group;
+
+    /**
+     * @brief Convert the PZD words of a response to actual values
+     */
+    void decodeActualValues(const uint16_t pzd[], g110ActualValues_t &values) const;
+
+    /**
+     * @brief Convert a frequency in Hz to main setpoint and control word flags for the direction
+     */
+    void frequencyToSetpoint(float freq, uint16_t &mainsetpoint, uint16_t &setFlags, uint16_t &clearFlags) const;
+
     USS *m_interface;
     float m_refFreq;
+    float m_refCurrent;
     int m_index;
 };
 
+/**
+ * @brief Group of G110 on the same USS interface, controlled together with broadcast telegrams
+ *
+ * All drives of the group get the same control word and setpoint in one telegram, so they start, stop and
+ * change frequency at the same time. A broadcast reaches every drive on the bus and sets the process image of
+ * every slave of the interface, so the group only sends when it contains a drive for every slave of its USS
+ * interface. The setpoint is the same word for all drives, so all drives of the group must have the same
+ * reference (motor) frequency. Telegrams with additional PZD words (USS_PZD_WORDS > 2) can't be broadcast
+ * without overwriting the additional setpoints of every drive, the group doesn't send with them.
+ */
+class G110Group
+{
+    public:
+
+    /**
+     * @brief Constructor for G110Group class, initializes the members
+     *
+     * @return none
+     */
+    G110Group();
+
+    /**
+     * @brief Add a drive to the group, the drive must be configured with begin() before
+     *
+     * @param drive the drive to add
+     * @retval 0: success
+     * @retval -1: drive not configured, on another USS interface, with another reference frequency than the
+     *              drives in the group, for a slave that has a drive in the group already or group full
+     */
+    int add(G110 *drive);
+
+    /**
+     * @brief Set frequency of all drives in the group, negative values for reverse rotation
+     *
+     * @param freq frequency in Hz
+     * @return 0 on success, -1 when the group doesn't have a drive for every slave of the interface or the
+     *         telegram has additional PZD words
+     */
+    int setFrequency(float freq);
+
+    /**
+     * @brief Set power stage of all drives in operating mode, sets ON/OFF1 flag, OFF2 and OFF3 appropriately
+     *
+     * @return 0 on success, -1 when the group doesn't have a drive for every slave of the interface or the
+     *         telegram has additional PZD words
+     */
+    int setON();
+
+    /**
+     * @brief Disable power stage of all drives, clears ON/OFF1 flag
+     *
+     * @return 0 on success, -1 when the group doesn't have a drive for every slave of the interface or the
+     *         telegram has additional PZD words
+     */
+    int setOFF1();
+
+    /**
+     * @brief Set one or more flags in control word of all drives
+     *
+     * @param flags control flags to set, for flags refer to G110 user manual
+     * @return 0 on success, -1 when the group doesn't have a drive for every slave of the interface or the
+     *         telegram has additional PZD words
+     */
+    int setCtlFlag(const uint16_t flags);
+
+    /**
+     * @brief Clear one or more flags in control word of all drives
+     *
+     * @param flags control flags to clear, for flags refer to G110 user manual
+     * @return 0 on success, -1 when the group doesn't have a drive for every slave of the interface or the
+     *         telegram has additional PZD words
+     */
+    int clearCtlFlag(const uint16_t flags);
+
+    private:
+
+    /**
+     * @brief Check that the group has a drive for every slave of its interface
+     */
+    bool complete() const;
+
+    G110 *m_drives[USS_SLAVES];
+    int m_nrDrives;
+    uint16_t m_ctlword;
+    uint16_t m_mainsetpoint;
+};
+
 #endif
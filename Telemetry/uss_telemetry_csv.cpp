@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   uss_telemetry_csv.cpp
+ *   @brief  Export of a telemetry log written by USSTelemetry to CSV on stdout, one line per record from the
+ *           oldest to the newest. Records can be selected by index, by time relative to the oldest record
+ *           and by slave. With the reference frequency of the drive (P2000) the main setpoint and main actual
+ *           value are also printed in Hz. The setpoint is negative when the control word commands reverse, the
+ *           actual value when the status word reports that the motor doesn't run right, so a reversal shows
+ *           the ramp through zero with the direction the motor really turns.
+ *
+ *           usage: uss_telemetry_csv [-f first] [-n count] [-t from_ms] [-T to_ms] [-s slave] [-r ref_hz] log
+ *   @date   17.10.2026
+ */
+#include <G110.h>
+#include <USSTelemetry.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Value of a PZD word in Hz like G110::getFrequency(), FREQUENCY_CALC_BASE is the reference frequency
+ *        and the direction is not part of the word
+ */
+static double toHz(const uint16_t value, const bool reverse, const double refHz)
+{
+    const double hz = (double)value * refHz / FREQUENCY_CALC_BASE;
+
+    return reverse ? -hz : hz;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long first = 0;
+    unsigned long count = (unsigned long)-1;
+    long long fromMs = -1;
+    long long toMs = -1;
+    int slave = -1;
+    double refHz = 0;
+    int opt;
+    int fd;
+    struct stat st;
+    const ussTelemetryHeader_t *header;
+    const ussTelemetrySample_t *records;
+    uint64_t oldest;
+    uint64_t available;
+    uint64_t startNs;
+
+    while((opt = getopt(argc, argv, "f:n:t:T:s:r:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'f':
+                first = strtoul(optarg, nullptr, 0);
+                break;
+
+            case 'n':
+                count = strtoul(optarg, nullptr, 0);
+                break;
+
+            case 't':
+                fromMs = atoll(optarg);
+                break;
+
+            case 'T':
+                toMs = atoll(optarg);
+                break;
+
+            case 's':
+                slave = atoi(optarg);
+                break;
+
+            case 'r':
+                refHz = atof(optarg);
+                break;
+
+            default:
+                fprintf(stderr, "usage: %s [-f first] [-n count] [-t from_ms] [-T to_ms] [-s slave] [-r ref_hz] log\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+
+    if(optind >= argc)
+    {
+        fprintf(stderr, "usage: %s [-f first] [-n count] [-t from_ms] [-T to_ms] [-s slave] [-r ref_hz] log\n", argv[0]);
+        return 1;
+    }
+
+    fd = open(argv[optind], O_RDONLY);
+
+    if(fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ussTelemetryHeader_t))
+    {
+        fprintf(stderr, "can't read %s\n", argv[optind]);
+        return 1;
+    }
+
+    header = static_cast<const ussTelemetryHeader_t *>(mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0));
+
+    if(header == MAP_FAILED)
+    {
+        fprintf(stderr, "can't map %s\n", argv[optind]);
+        return 1;
+    }
+
+    if(header->magic != USS_TELEMETRY_MAGIC || header->version != USS_TELEMETRY_VERSION ||
+       header->recordSize != sizeof(ussTelemetrySample_t) || header->capacity == 0 ||
+       (size_t)st.st_size < sizeof(ussTelemetryHeader_t) + header->capacity * sizeof(ussTelemetrySample_t))
+    {
+        fprintf(stderr, "%s is no telemetry log of this version\n", argv[optind]);
+        return 1;
+    }
+
+    // the file keeps the last capacity records, index 0 is the oldest one still in it
+    records = reinterpret_cast<const ussTelemetrySample_t *>(header + 1);
+    available = header->count < header->capacity ? header->count : header->capacity;
+    oldest = header->count - available;
+    startNs = available > 0 ? records[oldest % header->capacity].timeNs : 0;
+
+    fprintf(stderr, "%llu records, %llu overwritten, %llu dropped\n", (unsigned long long)available,
+            (unsigned long long)oldest, (unsigned long long)header->dropped);
+
+    printf("record,time_ms,cycle,slave,valid,statusword,mainactualvalue,ctlword,mainsetpoint%s\n",
+           refHz > 0 ? ",actual_hz,setpoint_hz" : "");
+
+    for(uint64_t i = first; i < available && count > 0; i++)
+    {
+        const ussTelemetrySample_t &sample = records[(oldest + i) % header->capacity];
+        const double timeMs = (sample.timeNs - startNs) / 1e6;
+
+        if((fromMs >= 0 && timeMs < fromMs) || (slave >= 0 && sample.slave != slave))
+            continue;
+
+        if(toMs >= 0 && timeMs > toMs)
+            break;
+
+        printf("%llu,%.3f,%u,%u,%u,0x%04X,%u,0x%04X,%u", (unsigned long long)i, timeMs, sample.cycle,
+               sample.slave, sample.valid, sample.statusword, sample.mainactualvalue, sample.ctlword,
+               sample.mainsetpoint);
+
+        if(refHz > 0)
+        {
+            // the commanded direction changes at once, the actual one only after the ramp through zero,
+            // like G110::reverse()
+            const bool runsReverse = !(sample.statusword & STATUS_WORD_MOTOR_RUNS_RIGHT_FLAG);
+            const bool setReverse = sample.ctlword & CTL_WORD_REVERSE_FALG;
+
+            printf(",%.2f,%.2f", toHz(sample.mainactualvalue, runsReverse, refHz),
+                   toHz(sample.mainsetpoint, setReverse, refHz));
+        }
+
+        printf("\n");
+        count--;
+    }
+
+    munmap(const_cast<ussTelemetryHeader_t *>(header), st.st_size);
+    close(fd);
+
+    return 0;
+}
@@ -35,8 +35,72 @@
  *   @date   30.07.2021
  */
 #include "USS.h"
+#include "USSTransport.h"
+#include "USSTelemetry.h"
+#include <errno.h>
+#include <malloc.h>
+#include <sched.h>
+#include <sys/mman.h>
 
-extern USS uss;
+#ifdef USS_RT_ALLOC_CHECK
+#include <new>
+#include <stdlib.h>
+
+// allocations of the bus thread, the thread counts its own without atomics
+static thread_local bool ussCountAllocations = false;
+static thread_local unsigned long ussAllocations = 0;
+
+void *operator new(size_t size)
+{
+    void *ret;
+
+    if(ussCountAllocations)
+        ussAllocations++;
+
+    ret = malloc(size);
+
+    if(ret == nullptr)
+        throw std::bad_alloc();
+
+    return ret;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+#endif
+
+/**
+ * @brief Touch the stack of the bus thread, so it has no page faults in the cycle
+ */
+static void prefaultStack()
+{
+    volatile byte stack[USS_RT_STACK_PREFAULT];
+
+    for(size_t i = 0; i < sizeof(stack); i += 1024)
+        stack[i] = 0;
+}
 
 USS::USS() :
     m_slaves{0},
@@ -44,239 +108,1589 @@ USS::USS() :
     m_actualSlave(0),
     m_sendBuffer{0},
     m_recvBuffer{0},
-    m_mainsetpoint{0},
-    m_mainactualvalue{0},
-    m_ctlword{0},
-    m_statusword{0},
-    m_paramValue{{0}, {0}},
-    m_nextSend(0),
+    m_parser(),
+    m_out(),
+    m_in(),
+    m_txFrame{},
+    m_txSeq{0},
+    m_pkw(),
+    m_trajectory(),
+    m_watches(),
+    m_nextSend{0, 0},
+    m_lastSend{0, 0},
     m_period(0),
     m_characterRuntime(0),
-    m_dePin(-1),
-	rs_begin(0),
-	rs_end(0)
+    m_transport(nullptr),
+    m_ownTransport(false),
+    m_respTimeout(0),
+    m_cycleStats(),
+    m_cycleStatsImage(),
+    m_slaveStats(),
+    m_slaveStatsImage(),
+    m_timingConfig{0, 0, 0},
+    m_timing(),
+    m_telegramRuntime(0),
+    m_txEnd{0, 0},
+    m_txFailed(false),
+    m_cyclicRun(false),
+    m_rtConfig{-1, 0, false},
+    m_cycleStart{0, 0},
+    m_cyclicThread(),
+    m_broadcast(0),
+    m_broadcastSent(false),
+    m_recorder(nullptr)
 {
     m_sendBuffer[0] = STX_BYTE_STX;
-    m_sendBuffer[1] = (PKW_LENGTH_CHARACTERS * PKW_ANZ) + (PZD_LENGTH_CHARACTERS * PZD_ANZ) + 2; // 2 for ADR and BCC bytes
+    m_sendBuffer[USS_LGE_OFFSET] = USS_LGE_VALUE;
+
+    for(int i = 0; i < USS_SLAVES; i++)
+    {
+        m_out.seq[i].store(0, std::memory_order_relaxed);
+        m_out.mainsetpoint[i].store(0, std::memory_order_relaxed);
+        m_out.ctlword[i].store(0, std::memory_order_relaxed);
+        m_in.seq[i].store(0, std::memory_order_relaxed);
+        m_in.mainactualvalue[i].store(0, std::memory_order_relaxed);
+        m_in.statusword[i].store(0, std::memory_order_relaxed);
+
+        for(int j = 0; j < USS_PZD_ADD_SLOTS; j++)
+        {
+            m_out.addsetpoint[j][i].store(0, std::memory_order_relaxed);
+            m_in.addactualvalue[j][i].store(0, std::memory_order_relaxed);
+        }
+
+        m_pkw[i].busy.store(false, std::memory_order_relaxed);
+        m_trajectory[i].active.store(false, std::memory_order_relaxed);
+        m_nrWatches[i].store(0, std::memory_order_relaxed);
+    }
+
+    pthread_mutex_init(&m_pkwLock, nullptr);
+    pthread_mutex_init(&m_cacheLock, nullptr);
+    pthread_mutex_init(&m_trajectoryLock, nullptr);
+    pthread_mutex_init(&m_watchLock, nullptr);
+}
+
+USS::~USS()
+{
+    stopCyclic();
+
+    if(m_transport != nullptr)
+        m_transport->close();
+
+    if(m_ownTransport)
+        delete m_transport;
+
+    pthread_mutex_destroy(&m_pkwLock);
+    pthread_mutex_destroy(&m_cacheLock);
+    pthread_mutex_destroy(&m_trajectoryLock);
+    pthread_mutex_destroy(&m_watchLock);
 }
 
-int USS::begin(char *sertty, unsigned int speed, const char slaves[], const int nrSlaves, const int dePin)
+int USS::begin(USSTransport *transport, const char *sertty, unsigned int speed, const char slaves[], const int nrSlaves)
 {
     int telegramRuntime;
-    rs_begin= clock();
-    if(nrSlaves > USS_SLAVES || slaves == nullptr)
+
+    if(nrSlaves < 1 || nrSlaves > USS_SLAVES || slaves == nullptr || transport == nullptr || speed == 0 ||
+       m_transport != nullptr)
+        return -1;
+
+    for(int i = 0; i < nrSlaves; i++)
+    {
+        if((byte)slaves[i] > ADDR_BYTE_ADDR_MASK)
+            return -1;
+
+        for(int j = 0; j < i; j++)
+        {
+            if(slaves[i] == slaves[j])
+                return -1;
+        }
+    }
+
+    if(transport->open(sertty, speed) != 0)
         return -1;
+
+    m_transport = transport;
+    m_parser.reset();
     memcpy(m_slaves, slaves, nrSlaves);
 
+    // the frames are complete telegrams from the start, send() only patches the words that changed
+    for(int i = 0; i < nrSlaves; i++)
+    {
+        memset(m_txFrame[i], 0, USS_BUFFER_LENGTH);
+        m_txFrame[i][0] = STX_BYTE_STX;
+        m_txFrame[i][USS_LGE_OFFSET] = USS_LGE_VALUE;
+        m_txFrame[i][USS_ADR_OFFSET] = slaves[i] & ADDR_BYTE_ADDR_MASK;
+        m_txFrame[i][USS_BCC_OFFSET] = ussBCC(m_txFrame[i], USS_BCC_OFFSET);
+        // odd sequence numbers are never read, so the first telegram takes over the process image
+        m_txSeq[i] = 1;
+    }
+
     m_nrSlaves = nrSlaves;
-    m_dePin = dePin;
-    m_characterRuntime = CHARACTER_RUNTIME_BASE_US / (speed / BAUDRATE_BASE);
+    m_characterRuntime = CHARACTER_RUNTIME_BASE_US * BAUDRATE_BASE / speed;
     telegramRuntime = USS_BUFFER_LENGTH * m_characterRuntime * 1.5f / 1000;
-    serOpen(sertty,speed, 0);
-    //Serial1.setTimeout(telegramRuntime + MAX_RESP_DELAY_TIME_MS);
-    gpioSetMode(m_dePin,PI_OUTPUT);
-    gpioWrite(m_dePin, 1);
-    m_period = telegramRuntime * 2 + (START_DELAY_LENGTH_CHARACTERS * m_characterRuntime / 1000) + MAX_RESP_DELAY_TIME_MS + MASTER_COMPUTE_DELAY_MS;
+    m_respTimeout = (long long)USS_BUFFER_LENGTH * m_characterRuntime * 1.5f * NSEC_PER_USEC +
+                    (long long)MAX_RESP_DELAY_TIME_MS * NSEC_PER_MSEC;
+
+    m_period = (telegramRuntime * 2 + (START_DELAY_LENGTH_CHARACTERS * m_characterRuntime / 1000) + MAX_RESP_DELAY_TIME_MS + MASTER_COMPUTE_DELAY_MS) * 1000;
+    m_telegramRuntime = USS_BUFFER_LENGTH * m_characterRuntime * 1.5f + START_DELAY_LENGTH_CHARACTERS * m_characterRuntime;
+
+    memset(&m_cycleStats, 0, sizeof(m_cycleStats));
+    memset(m_slaveStats, 0, sizeof(m_slaveStats));
+    m_cycleStats.period = m_period;
+
+    for(int i = 0; i < m_nrSlaves; i++)
+    {
+        m_timing[i].count = 0;
+        m_timing[i].failures = 0;
+        m_timing[i].gap = m_period;
+        m_timing[i].skip = 0;
+        m_slaveStats[i].gap = m_period;
+    }
+
+    publishStats(m_cycleStatsImage.seq, m_cycleStatsImage.words, &m_cycleStats, sizeof(m_cycleStats));
+
+    for(int i = 0; i < m_nrSlaves; i++)
+        publishStats(m_slaveStatsImage[i].seq, m_slaveStatsImage[i].words, &m_slaveStats[i], sizeof(m_slaveStats[i]));
+
+    clock_gettime(CLOCK_MONOTONIC, &m_nextSend);
+    m_lastSend = m_nextSend;
 
     return 0;
 }
 
-double USS::millis(double start,double stop )
+void USS::getCycleStats(ussCycleStats_t &stats) const
 {
-	double diff= stop - start;
-	return diff;
+    readStats(m_cycleStatsImage.seq, m_cycleStatsImage.words, &stats, sizeof(stats));
 }
 
-int USS::setParameter(const uint16_t param, const uint16_t value, const int slaveIndex)
+int USS::getSlaveStats(ussSlaveStats_t &stats, const int slaveIndex) const
 {
-    int ret = 0;
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves)
+        return -1;
 
-    if(slaveIndex >= m_nrSlaves)
+    readStats(m_slaveStatsImage[slaveIndex].seq, m_slaveStatsImage[slaveIndex].words, &stats, sizeof(stats));
+
+    return 0;
+}
+
+int USS::startCyclic(const int cpu)
+{
+    ussRtConfig_t config = {cpu, 0, false};
+
+    return startCyclic(config);
+}
+
+int USS::startCyclic(const ussRtConfig_t &config)
+{
+    pthread_attr_t attr;
+    struct sched_param param;
+    cpu_set_t cpus;
+    int ret;
+
+    if(m_transport == nullptr || m_cyclicRun.load() || config.priority < 0 ||
+       config.priority > sched_get_priority_max(SCHED_FIFO))
         return -1;
 
-    m_paramValue[0][slaveIndex] = (param & PKE_WORD_PARAM_MASK) | PKE_WORD_AK_CHW_PWE;
-    m_paramValue[1][slaveIndex] = 0;
-    m_paramValue[2][slaveIndex] = 0;
-    m_paramValue[3][slaveIndex] = value;
+    pthread_attr_init(&attr);
+
+    if(config.cpu >= 0)
+    {
+        CPU_ZERO(&cpus);
+        CPU_SET(config.cpu, &cpus);
+
+        if(pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus) != 0)
+        {
+            pthread_attr_destroy(&attr);
+            return -1;
+        }
+    }
 
-    while(m_paramValue[0][slaveIndex] != PARAM_VALUE_EMPTY)
+    if(config.priority > 0)
     {
-        send();
-        ret = receive();
+        param.sched_priority = config.priority;
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
     }
 
-    return ret;
+    if(config.lockMemory)
+    {
+        // a small stack, all of it is locked with the rest of the process
+        pthread_attr_setstacksize(&attr, USS_RT_STACK_SIZE);
+
+        if(mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            pthread_attr_destroy(&attr);
+            return -2;
+        }
+
+        // freed memory stays with the process and large blocks aren't mapped on demand, so later allocations
+        // of the application don't fault either
+        mallopt(M_TRIM_THRESHOLD, -1);
+        mallopt(M_MMAP_MAX, 0);
+    }
+
+    m_rtConfig = config;
+    m_cyclicRun.store(true);
+    ret = pthread_create(&m_cyclicThread, &attr, cyclicThread, this);
+    pthread_attr_destroy(&attr);
+
+    if(ret != 0)
+    {
+        m_cyclicRun.store(false);
+        return ret == EPERM ? -2 : -1;
+    }
+
+    return 0;
 }
 
-int USS::setParameter(const uint16_t param, const uint32_t value, const int slaveIndex)
+void USS::stopCyclic()
 {
-    int ret = 0;
+    if(!m_cyclicRun.load())
+        return;
 
-    if(slaveIndex >= m_nrSlaves)
+    m_cyclicRun.store(false);
+    pthread_join(m_cyclicThread, nullptr);
+}
+
+bool USS::cyclicRunning() const
+{
+    return m_cyclicRun.load();
+}
+
+void USS::setRecorder(USSTelemetry *recorder)
+{
+    m_recorder = recorder;
+}
+
+int USS::setTiming(const ussTimingConfig_t &config)
+{
+    if(config.percentile < 0 || config.percentile > 100 || config.marginUs < 0 || config.maxFailures < 0)
         return -1;
 
-    m_paramValue[0][slaveIndex] = (param & PKE_WORD_PARAM_MASK) | PKE_WORD_AK_CHD_PWE;
-    m_paramValue[1][slaveIndex] = 0;
-    m_paramValue[2][slaveIndex] = (value >> 16) & 0xFFFF;
-    m_paramValue[3][slaveIndex] = value & 0xFFFF;
+    m_timingConfig = config;
 
-    while(m_paramValue[0][slaveIndex] != PARAM_VALUE_EMPTY)
+    for(int i = 0; i < m_nrSlaves; i++)
     {
-        send();
-        ret = receive();
+        m_timing[i].count = 0;
+        m_timing[i].failures = 0;
+        m_timing[i].gap = m_period;
     }
 
-    return ret;
+    return 0;
+}
+
+void USS::updateTiming(const int slaveIndex, const bool valid, const long latency)
+{
+    timingSlave_t &timing = m_timing[slaveIndex];
+    ussSlaveStats_t &stats = m_slaveStats[slaveIndex];
+    long gap;
+    int rank;
+
+    if(m_timingConfig.percentile == 0 || m_txFailed)
+        return;
+
+    if(!valid)
+    {
+        // a slave that stops answering gets the spec timing back at once and is measured again
+        if(++timing.failures > m_timingConfig.maxFailures)
+        {
+            if(timing.gap != (long)m_period)
+                stats.timingFallbacks++;
+
+            timing.gap = m_period;
+            timing.count = 0;
+            timing.failures = 0;
+        }
+
+        stats.gap = timing.gap;
+        return;
+    }
+
+    timing.samples[timing.count++] = latency;
+
+    if(timing.count < USS_TIMING_SAMPLES)
+        return;
+
+    // sorted in place by insertion, the samples are dropped after the gap is taken from them
+    for(int i = 1; i < USS_TIMING_SAMPLES; i++)
+    {
+        const long sample = timing.samples[i];
+        int j = i;
+
+        for(; j > 0 && timing.samples[j - 1] > sample; j--)
+            timing.samples[j] = timing.samples[j - 1];
+
+        timing.samples[j] = sample;
+    }
+
+    rank = (m_timingConfig.percentile * USS_TIMING_SAMPLES + 99) / 100;
+    gap = m_telegramRuntime + timing.samples[rank > 0 ? rank - 1 : 0] + m_timingConfig.marginUs;
+
+    timing.gap = gap < (long)m_period ? gap : m_period;
+    timing.count = 0;
+    timing.failures = 0;
+    stats.gap = timing.gap;
+}
+
+void *USS::cyclicThread(void *arg)
+{
+    USS *uss = static_cast<USS *>(arg);
+    struct timespec now;
+
+    if(uss->m_rtConfig.lockMemory)
+        prefaultStack();
+
+#ifdef USS_RT_ALLOC_CHECK
+    ussCountAllocations = true;
+#endif
+
+    while(uss->m_cyclicRun.load(std::memory_order_relaxed))
+    {
+        uss->send();
+        uss->receive();
+
+        // runtime includes the wait for the response, so it shows how much of the period is left
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        uss->m_cycleStats.lastRuntime = ussTimespecDiffNs(now, uss->m_cycleStart) / NSEC_PER_USEC;
+
+        if(uss->m_cycleStats.lastRuntime > uss->m_cycleStats.maxRuntime)
+            uss->m_cycleStats.maxRuntime = uss->m_cycleStats.lastRuntime;
+    }
+
+    return nullptr;
+}
+
+int USS::setParameter(const uint16_t param, const uint16_t value, const int slaveIndex, const int timeoutMs,
+                      const int retries)
+{
+    paramSync_t sync;
+
+    sync.done.store(false);
+    sync.result = USS_PKW_ERR_TIMEOUT;
+
+    if(setParameterAsync(param, value, slaveIndex, paramSyncCallback, &sync, timeoutMs, retries) != 0)
+        return -1;
+
+    return waitParameter(sync);
 }
 
-int USS::setParameter(const uint16_t param, const float value, const int slaveIndex)
+int USS::setParameter(const uint16_t param, const uint32_t value, const int slaveIndex, const int timeoutMs,
+                      const int retries)
+{
+    paramSync_t sync;
+
+    sync.done.store(false);
+    sync.result = USS_PKW_ERR_TIMEOUT;
+
+    if(setParameterAsync(param, value, slaveIndex, paramSyncCallback, &sync, timeoutMs, retries) != 0)
+        return -1;
+
+    return waitParameter(sync);
+}
+
+int USS::setParameter(const uint16_t param, const float value, const int slaveIndex, const int timeoutMs,
+                      const int retries)
 {
     parameter_t p;
 
     p.f32 = value;
 
-    return setParameter(param, p.u32, slaveIndex);
+    return setParameter(param, p.u32, slaveIndex, timeoutMs, retries);
 }
 
-void USS::setMainsetpoint(const uint16_t value, const int slaveIndex)
+int USS::setParameterAsync(const uint16_t param, const uint16_t value, const int slaveIndex,
+                           ussParamCallback_t callback, void *context, const int timeoutMs, const int retries)
 {
-    if(slaveIndex >= m_nrSlaves)
-        return;
+    return setParameterIndexAsync(param, 0, value, slaveIndex, callback, context, timeoutMs, retries);
+}
+
+int USS::setParameterIndexAsync(const uint16_t param, const uint16_t index, const uint16_t value, const int slaveIndex,
+                                ussParamCallback_t callback, void *context, const int timeoutMs, const int retries)
+{
+    ussParamJob_t job;
+
+    job.pke = (param & PKE_WORD_PARAM_MASK) | PKE_WORD_AK_CHW_PWE;
+    job.ind = index;
+    job.pwe[0] = 0;
+    job.pwe[1] = value;
+    job.timeoutMs = timeoutMs;
+    job.retries = retries;
+    job.callback = callback;
+    job.context = context;
 
-    m_mainsetpoint[slaveIndex] = value;
+    return queueParamJob(job, slaveIndex);
 }
 
-void USS::setCtlFlag(const uint16_t flags, const int slaveIndex)
+int USS::setParameterAsync(const uint16_t param, const uint32_t value, const int slaveIndex,
+                           ussParamCallback_t callback, void *context, const int timeoutMs, const int retries)
 {
-    if(slaveIndex >= m_nrSlaves)
-        return;
+    return setParameterIndexAsync(param, 0, value, slaveIndex, callback, context, timeoutMs, retries);
+}
+
+int USS::setParameterIndexAsync(const uint16_t param, const uint16_t index, const uint32_t value, const int slaveIndex,
+                                ussParamCallback_t callback, void *context, const int timeoutMs, const int retries)
+{
+    ussParamJob_t job;
 
-    m_ctlword[slaveIndex] |= flags;
+    job.pke = (param & PKE_WORD_PARAM_MASK) | PKE_WORD_AK_CHD_PWE;
+    job.ind = index;
+    job.pwe[0] = (value >> 16) & 0xFFFF;
+    job.pwe[1] = value & 0xFFFF;
+    job.timeoutMs = timeoutMs;
+    job.retries = retries;
+    job.callback = callback;
+    job.context = context;
+
+    return queueParamJob(job, slaveIndex);
 }
 
-void USS::clearCtlFlag(const uint16_t flags, const int slaveIndex)
+int USS::setParameterAsync(const uint16_t param, const float value, const int slaveIndex,
+                           ussParamCallback_t callback, void *context, const int timeoutMs, const int retries)
 {
-    if(slaveIndex >= m_nrSlaves)
-        return;
+    parameter_t p;
+
+    p.f32 = value;
 
-    m_ctlword[slaveIndex] &= ~flags;
+    return setParameterAsync(param, p.u32, slaveIndex, callback, context, timeoutMs, retries);
 }
 
-uint16_t USS::getActualvalue(const int slaveIndex) const
+int USS::setParameterIndexAsync(const uint16_t param, const uint16_t index, const float value, const int slaveIndex,
+                                ussParamCallback_t callback, void *context, const int timeoutMs, const int retries)
 {
-    if(slaveIndex >= m_nrSlaves)
-        return -1;
+    parameter_t p;
 
-    uint16_t ret;
+    p.f32 = value;
+
+    return setParameterIndexAsync(param, index, p.u32, slaveIndex, callback, context, timeoutMs, retries);
+}
+
+int USS::getParameter(const uint16_t param, uint16_t &value, const int slaveIndex, const uint16_t index,
+                      const int maxAgeMs, const int timeoutMs, const int retries)
+{
+    uint32_t v;
+    int ret;
+
+    ret = getParameter(param, v, slaveIndex, index, maxAgeMs, timeoutMs, retries);
 
-    ret = m_mainactualvalue[slaveIndex];
+    if(ret == 0)
+        value = v & 0xFFFF;
 
     return ret;
 }
 
-bool USS::checkStatusFlag(const uint16_t flag, const int slaveIndex) const
+int USS::getParameter(const uint16_t param, uint32_t &value, const int slaveIndex, const uint16_t index,
+                      const int maxAgeMs, const int timeoutMs, const int retries)
 {
-    if(slaveIndex >= m_nrSlaves)
-        return false;
+    paramSync_t sync;
+
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves)
+        return -1;
+
+    if(maxAgeMs != 0 && readParamCache(param, index, slaveIndex, maxAgeMs, value))
+        return 0;
+
+    sync.done.store(false);
+    sync.result = USS_PKW_ERR_TIMEOUT;
+    sync.value = 0;
+
+    if(getParameterAsync(param, slaveIndex, index, paramSyncCallback, &sync, timeoutMs, retries) != 0)
+        return -1;
+
+    if(waitParameter(sync) != 0)
+        return sync.result;
 
-    return (m_statusword[slaveIndex] & flag) != 0 ? true : false;
+    value = sync.value;
+
+    return 0;
 }
 
-byte USS::BCC(const char buffer[], const int length) const
+int USS::getParameter(const uint16_t param, float &value, const int slaveIndex, const uint16_t index,
+                      const int maxAgeMs, const int timeoutMs, const int retries)
 {
-    byte ret = 0;
+    parameter_t p;
+    int ret;
+
+    ret = getParameter(param, p.u32, slaveIndex, index, maxAgeMs, timeoutMs, retries);
 
-    for(int i = 0; i < length; i++)
-        ret = ret ^ buffer[i];
+    if(ret == 0)
+        value = p.f32;
 
     return ret;
 }
 
-void USS::send()
+int USS::getParameterAsync(const uint16_t param, const int slaveIndex, const uint16_t index,
+                           ussParamCallback_t callback, void *context, const int timeoutMs, const int retries)
 {
-    while(!(millis(rs_begin,rs_end) > m_nextSend && (millis(rs_begin,rs_end) - m_nextSend) < 10000));
+    ussParamJob_t job;
 
-    m_nextSend = millis(rs_begin,rs_end) + m_period;
+    job.pke = (param & PKE_WORD_PARAM_MASK) | PKE_WORD_AK_REQ_PWE;
+    job.ind = index;
+    job.pwe[0] = 0;
+    job.pwe[1] = 0;
+    job.timeoutMs = timeoutMs;
+    job.retries = retries;
+    job.callback = callback;
+    job.context = context;
 
-    if(m_actualSlave == m_nrSlaves)
-        m_actualSlave = 0;
+    return queueParamJob(job, slaveIndex);
+}
 
-    m_sendBuffer[2] = m_slaves[m_actualSlave] & ADDR_BYTE_ADDR_MASK;
+void USS::invalidateParameterCache(const int slaveIndex)
+{
+    pthread_mutex_lock(&m_cacheLock);
 
-    if(m_paramValue[0][m_actualSlave] != PARAM_VALUE_EMPTY)
-    {
-        m_sendBuffer[3] = (m_paramValue[0][m_actualSlave] >> 8) & 0xFF;
-        m_sendBuffer[4] = m_paramValue[0][m_actualSlave] & 0xFF;
-        m_sendBuffer[5] = (m_paramValue[1][m_actualSlave] >> 8) & 0xFF;
-        m_sendBuffer[6] = m_paramValue[1][m_actualSlave] & 0xFF;
-        m_sendBuffer[7] = (m_paramValue[2][m_actualSlave] >> 8) & 0xFF;
-        m_sendBuffer[8] = m_paramValue[2][m_actualSlave] & 0xFF;
-        m_sendBuffer[9] = (m_paramValue[3][m_actualSlave] >> 8) & 0xFF;
-        m_sendBuffer[10] = m_paramValue[3][m_actualSlave] & 0xFF;
-    }
-    else
+    for(int i = 0; i < m_nrSlaves; i++)
     {
-        m_sendBuffer[3] = 0;
-        m_sendBuffer[4] = 0;
-        m_sendBuffer[5] = 0;
-        m_sendBuffer[6] = 0;
-        m_sendBuffer[7] = 0;
-        m_sendBuffer[8] = 0;
-        m_sendBuffer[9] = 0;
-        m_sendBuffer[10] = 0;
+        if(slaveIndex >= 0 && slaveIndex != i)
+            continue;
+
+        for(int j = 0; j < USS_PARAM_CACHE_LENGTH; j++)
+            m_pkw[i].cache[j].valid = false;
     }
 
-    m_sendBuffer[PKW_LENGTH_CHARACTERS * PKW_ANZ + 3] = (m_ctlword[m_actualSlave] >> 8) & 0xFF;
-    m_sendBuffer[PKW_LENGTH_CHARACTERS * PKW_ANZ + 4] = m_ctlword[m_actualSlave] & 0xFF;
-    m_sendBuffer[PKW_LENGTH_CHARACTERS * PKW_ANZ + 5] = (m_mainsetpoint[m_actualSlave] >> 8) & 0xFF;
-    m_sendBuffer[PKW_LENGTH_CHARACTERS * PKW_ANZ + 6] = m_mainsetpoint[m_actualSlave] & 0xFF;
+    pthread_mutex_unlock(&m_cacheLock);
+}
+
+void USS::invalidateParameter(const uint16_t param, const uint16_t index, const int slaveIndex)
+{
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves)
+        return;
+
+    pthread_mutex_lock(&m_cacheLock);
 
-    m_sendBuffer[USS_BUFFER_LENGTH - 1] = BCC(m_sendBuffer, USS_BUFFER_LENGTH - 1);
+    for(int j = 0; j < USS_PARAM_CACHE_LENGTH; j++)
+    {
+        paramCacheEntry_t &entry = m_pkw[slaveIndex].cache[j];
 
-    serWrite(0, m_sendBuffer, USS_BUFFER_LENGTH);
-    //you need to log error here in case send data failed !!!!!
+        if(entry.valid && entry.param == (param & PKE_WORD_PARAM_MASK) && entry.index == index)
+            entry.valid = false;
+    }
 
-    usleep(START_DELAY_LENGTH_CHARACTERS * m_characterRuntime);
-    rs_end= clock()
-	gpioWrite(m_dePin, 0);
+    pthread_mutex_unlock(&m_cacheLock);
 }
 
-int USS::receive()
+bool USS::readParamCache(const uint16_t param, const uint16_t index, const int slaveIndex, const int maxAgeMs,
+                         uint32_t &value) const
 {
-    int ret = 0;
+    struct timespec now;
+    bool ret = false;
 
-    if(serRead(0,m_recvBuffer, USS_BUFFER_LENGTH) == USS_BUFFER_LENGTH &&
-        m_recvBuffer[0] == STX_BYTE_STX && (m_recvBuffer[2] & ADDR_BYTE_ADDR_MASK) == (m_slaves[m_actualSlave] & ADDR_BYTE_ADDR_MASK) &&
-        BCC(m_recvBuffer, USS_BUFFER_LENGTH - 1) == m_recvBuffer[USS_BUFFER_LENGTH - 1])
-    {
-        m_statusword[m_actualSlave] = (m_recvBuffer[PKW_LENGTH_CHARACTERS * PKW_ANZ + 3] << 8) & 0xFF00;
-        m_statusword[m_actualSlave] |= m_recvBuffer[PKW_LENGTH_CHARACTERS * PKW_ANZ + 4] & 0xFF;
-        m_mainactualvalue[m_actualSlave] = (m_recvBuffer[PKW_LENGTH_CHARACTERS * PKW_ANZ + 5] << 8) & 0xFF00;
-        m_mainactualvalue[m_actualSlave] |= m_recvBuffer[PKW_LENGTH_CHARACTERS * PKW_ANZ + 6] & 0xFF;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    pthread_mutex_lock(&m_cacheLock);
 
-        if(m_paramValue[0][m_actualSlave] != PARAM_VALUE_EMPTY)
-        {
-            if(((m_recvBuffer[3] << 8) & PKE_WORD_AK_MASK) == PKE_WORD_AK_NO_RESP)
-                ret = -1;
-            if(((m_recvBuffer[3] << 8) & PKE_WORD_AK_MASK) == PKE_WORD_AK_NO_RIGHTS)
-                ret = -2;
-            if(((m_recvBuffer[3] << 8) & PKE_WORD_AK_MASK) == PKE_WORD_AK_CANT_EXECUTE)
-            {
-                ret = m_recvBuffer[10] | m_recvBuffer[9] << 8;
+    for(int j = 0; j < USS_PARAM_CACHE_LENGTH; j++)
+    {
+        const paramCacheEntry_t &entry = m_pkw[slaveIndex].cache[j];
 
-                if(!ret)
-                    ret = -3;   // 0 is error code for illegal parameter number
-            }
+        if(!entry.valid || entry.param != (param & PKE_WORD_PARAM_MASK) || entry.index != index)
+            continue;
 
-            m_paramValue[0][m_actualSlave] = PARAM_VALUE_EMPTY;
+        if(maxAgeMs < 0 || ussTimespecDiffNs(now, entry.stamp) <= (long long)maxAgeMs * NSEC_PER_MSEC)
+        {
+            value = entry.value;
+            ret = true;
         }
+
+        break;
     }
-    else
+
+    pthread_mutex_unlock(&m_cacheLock);
+
+    return ret;
+}
+
+void USS::writeParamCache(const uint16_t param, const uint16_t index, const int slaveIndex, const uint32_t value)
+{
+    paramCacheEntry_t *slot = nullptr;
+
+    pthread_mutex_lock(&m_cacheLock);
+
+    // take the entry of the parameter, a free one or replace the oldest
+    for(int j = 0; j < USS_PARAM_CACHE_LENGTH; j++)
     {
-        ret = -1;
+        paramCacheEntry_t &entry = m_pkw[slaveIndex].cache[j];
+
+        if(entry.valid && entry.param == param && entry.index == index)
+        {
+            slot = &entry;
+            break;
+        }
+
+        if(slot == nullptr || (slot->valid && (!entry.valid || ussTimespecDiffNs(entry.stamp, slot->stamp) < 0)))
+            slot = &entry;
     }
 
-    gpioWrite(m_dePin, 1);
+    slot->param = param;
+    slot->index = index;
+    slot->value = value;
+    slot->valid = true;
+    clock_gettime(CLOCK_MONOTONIC, &slot->stamp);
+
+    pthread_mutex_unlock(&m_cacheLock);
+}
+
+int USS::nrSlaves() const
+{
+    return m_nrSlaves;
+}
+
+int USS::pendingParameters(const int slaveIndex) const
+{
+    int ret;
+
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves)
+        return -1;
+
+    pthread_mutex_lock(&m_pkwLock);
+    ret = m_pkw[slaveIndex].count + (m_pkw[slaveIndex].busy ? 1 : 0);
+    pthread_mutex_unlock(&m_pkwLock);
+
+    return ret;
+}
+
+void USS::flushParameters()
+{
+    struct timespec period = {0, 0};
+    bool pending = true;
+
+    ussTimespecAddNs(period, (long long)m_period * NSEC_PER_USEC);
+
+    while(pending)
+    {
+        pending = false;
+
+        for(int i = 0; i < m_nrSlaves && !pending; i++)
+            pending = pendingParameters(i) > 0;
+
+        if(!pending)
+            break;
+
+        if(m_cyclicRun.load(std::memory_order_relaxed))
+        {
+            nanosleep(&period, nullptr);
+        }
+        else
+        {
+            send();
+            receive();
+        }
+    }
+}
+
+int USS::queueParamJob(ussParamJob_t &job, const int slaveIndex)
+{
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves || USS_PKW_WORDS == 0)
+        return -1;
+
+    // with 3 PKW words there is only one PWE word, double words can't be transferred
+    if(USS_PKW_WORDS == 3 && (job.pke & PKE_WORD_AK_MASK) == PKE_WORD_AK_CHD_PWE)
+        return -1;
+
+    pkwSlave_t &pkw = m_pkw[slaveIndex];
+
+    clock_gettime(CLOCK_MONOTONIC, &job.deadline);
+    ussTimespecAddNs(job.deadline, (long long)job.timeoutMs * NSEC_PER_MSEC);
+    job.tries = 0;
+    job.error = USS_PKW_ERR_TIMEOUT;
+
+    pthread_mutex_lock(&m_pkwLock);
+
+    if(pkw.count == USS_PKW_QUEUE_LENGTH)
+    {
+        pthread_mutex_unlock(&m_pkwLock);
+        return -1;
+    }
+
+    pkw.queue[(pkw.head + pkw.count) % USS_PKW_QUEUE_LENGTH] = job;
+    pkw.count++;
+
+    pthread_mutex_unlock(&m_pkwLock);
+
+    return 0;
+}
+
+void USS::nextParamJob(const int slaveIndex, const struct timespec &now)
+{
+    pkwSlave_t &pkw = m_pkw[slaveIndex];
+
+    if(pkw.busy && ussTimespecDiffNs(pkw.active.deadline, now) <= 0)
+        finishParamJob(slaveIndex, pkw.active.error, 0);
+
+    while(true)
+    {
+        // the bus never waits for application threads queuing jobs, the job is taken in a later cycle then
+        if(pkw.busy || pthread_mutex_trylock(&m_pkwLock) != 0)
+            return;
+
+        if(pkw.count == 0)
+        {
+            pthread_mutex_unlock(&m_pkwLock);
+            return;
+        }
+
+        pkw.active = pkw.queue[pkw.head];
+        pkw.head = (pkw.head + 1) % USS_PKW_QUEUE_LENGTH;
+        pkw.count--;
+        pkw.busy = true;
+
+        if(ussTimespecDiffNs(pkw.active.deadline, now) > 0)
+            break;
+
+        // a job that expired in the queue is not sent anymore, its callback is called without the lock, so it
+        // can queue new jobs
+        pthread_mutex_unlock(&m_pkwLock);
+        finishParamJob(slaveIndex, USS_PKW_ERR_TIMEOUT, 0);
+    }
+
+    // the slave repeats its old response until it processed the job, which can't be told apart from the
+    // response to the job when both have the same parameter number and index, so the slave is made to
+    // answer a no task first then
+    pkw.noTask = pkw.lastPke != 0 && pkw.active.ind == pkw.lastInd &&
+                 (pkw.active.pke & PKE_WORD_PARAM_MASK) == (pkw.lastPke & PKE_WORD_PARAM_MASK);
+    pkw.lastPke = pkw.active.pke;
+    pkw.lastInd = pkw.active.ind;
+
+    pthread_mutex_unlock(&m_pkwLock);
+}
+
+void USS::finishParamJob(const int slaveIndex, const int result, const uint32_t value)
+{
+    pkwSlave_t &pkw = m_pkw[slaveIndex];
+
+    // read and written values are cached, so reading them again costs no telegram
+    if(result == 0)
+        writeParamCache(pkw.active.pke & PKE_WORD_PARAM_MASK, pkw.active.ind, slaveIndex, value);
+
+    if(pkw.active.callback != nullptr)
+        pkw.active.callback(result, pkw.active.pke & PKE_WORD_PARAM_MASK, value, pkw.active.context);
+
+    // cleared after the callback, so everything the callback did is visible when pendingParameters() is 0
+    pkw.busy.store(false, std::memory_order_release);
+}
+
+bool USS::paramResponseMatches(const ussParamJob_t &job, const uint16_t pke, const uint16_t ind, const uint32_t pwe)
+{
+    const uint16_t ak = pke & PKE_WORD_AK_MASK;
+
+    if((pke & PKE_WORD_PARAM_MASK) != (job.pke & PKE_WORD_PARAM_MASK) || ind != job.ind)
+        return false;
+
+    if(ak == PKE_WORD_AK_CANT_EXECUTE || ak == PKE_WORD_AK_NO_RIGHTS)
+        return true;
+
+    switch(job.pke & PKE_WORD_AK_MASK)
+    {
+        // the type of the parameter is only known to the slave
+        case PKE_WORD_AK_REQ_PWE:
+            return ak == PKE_WORD_AK_TRW_PWE || ak == PKE_WORD_AK_TRD_PWE;
+
+        case PKE_WORD_AK_CHW_PWE:
+            return ak == PKE_WORD_AK_TRW_PWE && (pwe & 0xFFFF) == job.pwe[1];
+
+        case PKE_WORD_AK_CHD_PWE:
+            return ak == PKE_WORD_AK_TRD_PWE && pwe == ((uint32_t)job.pwe[0] << 16 | job.pwe[1]);
+
+        default:
+            return false;
+    }
+}
+
+void USS::paramSyncCallback(const int result, const uint16_t param, const uint32_t value, void *context)
+{
+    paramSync_t *sync = static_cast<paramSync_t *>(context);
+
+    (void)param;
+
+    sync->result = result;
+    sync->value = value;
+    sync->done.store(true, std::memory_order_release);
+}
+
+int USS::waitParameter(paramSync_t &sync)
+{
+    struct timespec period = {0, 0};
+
+    ussTimespecAddNs(period, (long long)m_period * NSEC_PER_USEC);
+
+    while(!sync.done.load(std::memory_order_acquire))
+    {
+        if(m_cyclicRun.load(std::memory_order_relaxed))
+        {
+            nanosleep(&period, nullptr);
+        }
+        else
+        {
+            send();
+            receive();
+        }
+    }
+
+    return sync.result;
+}
+
+void USS::setMainsetpoint(const uint16_t value, const int slaveIndex)
+{
+    if(slaveIndex >= m_nrSlaves)
+        return;
+
+    lockOutput(slaveIndex);
+    m_out.mainsetpoint[slaveIndex].store(value, std::memory_order_relaxed);
+    unlockOutput(slaveIndex);
+}
+
+void USS::setCtlFlag(const uint16_t flags, const int slaveIndex)
+{
+    if(slaveIndex >= m_nrSlaves)
+        return;
+
+    lockOutput(slaveIndex);
+    m_out.ctlword[slaveIndex].store(m_out.ctlword[slaveIndex].load(std::memory_order_relaxed) | flags, std::memory_order_relaxed);
+    unlockOutput(slaveIndex);
+}
+
+void USS::clearCtlFlag(const uint16_t flags, const int slaveIndex)
+{
+    if(slaveIndex >= m_nrSlaves)
+        return;
+
+    lockOutput(slaveIndex);
+    m_out.ctlword[slaveIndex].store(m_out.ctlword[slaveIndex].load(std::memory_order_relaxed) & ~flags, std::memory_order_relaxed);
+    unlockOutput(slaveIndex);
+}
+
+void USS::setOutputs(const uint16_t setFlags, const uint16_t clearFlags, const uint16_t value, const int slaveIndex)
+{
+    if(slaveIndex >= m_nrSlaves)
+        return;
+
+    lockOutput(slaveIndex);
+    m_out.ctlword[slaveIndex].store((m_out.ctlword[slaveIndex].load(std::memory_order_relaxed) & ~clearFlags) | setFlags,
+                                std::memory_order_relaxed);
+    m_out.mainsetpoint[slaveIndex].store(value, std::memory_order_relaxed);
+    unlockOutput(slaveIndex);
+}
+
+void USS::setAddSetpoint(const int pzd, const uint16_t value, const int slaveIndex)
+{
+    if(slaveIndex >= m_nrSlaves || pzd < 3 || pzd > USS_PZD_WORDS)
+        return;
+
+    lockOutput(slaveIndex);
+    m_out.addsetpoint[pzd - 3][slaveIndex].store(value, std::memory_order_relaxed);
+    unlockOutput(slaveIndex);
+}
+
+uint16_t USS::getActualvalue(const int slaveIndex) const
+{
+    if(slaveIndex >= m_nrSlaves)
+        return -1;
+
+    uint16_t status;
+    uint16_t ret;
+
+    readInput(slaveIndex, status, ret);
+
+    return ret;
+}
+
+uint16_t USS::getAddActualvalue(const int pzd, const int slaveIndex) const
+{
+    if(slaveIndex >= m_nrSlaves || pzd < 3 || pzd > USS_PZD_WORDS)
+        return -1;
+
+    return m_in.addactualvalue[pzd - 3][slaveIndex].load(std::memory_order_relaxed);
+}
+
+int USS::getInputs(uint16_t pzd[], const int slaveIndex) const
+{
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves)
+        return -1;
+
+    readInput(slaveIndex, pzd[0], pzd[1], pzd + 2);
+
+    return 0;
+}
+
+bool USS::checkStatusFlag(const uint16_t flag, const int slaveIndex) const
+{
+    if(slaveIndex >= m_nrSlaves)
+        return false;
+
+    uint16_t status;
+    uint16_t actual;
+
+    readInput(slaveIndex, status, actual);
+
+    return (status & flag) != 0 ? true : false;
+}
+
+int USS::broadcast(const uint16_t ctlword, const uint16_t mainsetpoint)
+{
+    // the additional setpoints are per slave and the broadcast can't carry them
+    if(m_nrSlaves == 0 || USS_PZD_ADD_WORDS > 0)
+        return -1;
+
+    // the process image of every slave gets the same values, so the following cyclic telegrams keep them
+    for(int i = 0; i < m_nrSlaves; i++)
+    {
+        lockOutput(i);
+        m_out.ctlword[i].store(ctlword, std::memory_order_relaxed);
+        m_out.mainsetpoint[i].store(mainsetpoint, std::memory_order_relaxed);
+        unlockOutput(i);
+    }
+
+    m_broadcast.store(USS_BROADCAST_PENDING | ((uint64_t)ctlword << 16) | mainsetpoint, std::memory_order_release);
+
+    return 0;
+}
+
+int USS::startTrajectory(const ussTrajectoryPoint_t points[], const int nrPoints, const int slaveIndex,
+                         const unsigned long periodMs)
+{
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves || points == nullptr || nrPoints < 1 ||
+       nrPoints > USS_TRAJECTORY_LENGTH || (periodMs > 0 && periodMs <= points[nrPoints - 1].timeMs))
+        return -1;
+
+    for(int i = 1; i < nrPoints; i++)
+    {
+        if(points[i].timeMs < points[i - 1].timeMs)
+            return -1;
+    }
+
+    trajectory_t &trajectory = m_trajectory[slaveIndex];
+
+    pthread_mutex_lock(&m_trajectoryLock);
+    memcpy(trajectory.points, points, nrPoints * sizeof(ussTrajectoryPoint_t));
+    trajectory.nrPoints = nrPoints;
+    trajectory.next = 0;
+    trajectory.periodMs = periodMs;
+    clock_gettime(CLOCK_MONOTONIC, &trajectory.start);
+    trajectory.active.store(true, std::memory_order_release);
+    pthread_mutex_unlock(&m_trajectoryLock);
+
+    return 0;
+}
+
+void USS::stopTrajectory(const int slaveIndex)
+{
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves)
+        return;
+
+    pthread_mutex_lock(&m_trajectoryLock);
+    m_trajectory[slaveIndex].active.store(false, std::memory_order_relaxed);
+    pthread_mutex_unlock(&m_trajectoryLock);
+}
+
+bool USS::trajectoryRunning(const int slaveIndex) const
+{
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves)
+        return false;
+
+    return m_trajectory[slaveIndex].active.load(std::memory_order_acquire);
+}
+
+void USS::runTrajectory(const int slaveIndex, const struct timespec &cycle)
+{
+    trajectory_t &trajectory = m_trajectory[slaveIndex];
+
+    // the bus thread doesn't wait for an application thread, the due points stay due until the next cycle
+    if(pthread_mutex_trylock(&m_trajectoryLock) != 0)
+        return;
+
+    while(trajectory.active.load(std::memory_order_relaxed))
+    {
+        const ussTrajectoryPoint_t &point = trajectory.points[trajectory.next];
+        struct timespec due = trajectory.start;
+
+        ussTimespecAddNs(due, (long long)point.timeMs * NSEC_PER_MSEC);
+
+        if(ussTimespecDiffNs(due, cycle) > 0 || !tryLockOutput(slaveIndex))
+            break;
+
+        m_out.ctlword[slaveIndex].store((m_out.ctlword[slaveIndex].load(std::memory_order_relaxed) & ~point.clearFlags) |
+                                        point.setFlags, std::memory_order_relaxed);
+        m_out.mainsetpoint[slaveIndex].store(point.mainsetpoint, std::memory_order_relaxed);
+        unlockOutput(slaveIndex);
+
+        if(++trajectory.next < trajectory.nrPoints)
+            continue;
+
+        // a periodic trajectory is started again relative to its last start, so it doesn't drift
+        if(trajectory.periodMs > 0)
+        {
+            trajectory.next = 0;
+            ussTimespecAddNs(trajectory.start, (long long)trajectory.periodMs * NSEC_PER_MSEC);
+        }
+        else
+        {
+            trajectory.active.store(false, std::memory_order_release);
+        }
+    }
+
+    pthread_mutex_unlock(&m_trajectoryLock);
+}
+
+int USS::waitStatusAsync(const uint16_t mask, const uint16_t value, const int slaveIndex, ussStatusCallback_t callback,
+                         void *context, const int timeoutMs)
+{
+    statusWatch_t watch;
+    int n;
+
+    if(slaveIndex < 0 || slaveIndex >= m_nrSlaves || callback == nullptr)
+        return -1;
+
+    watch.mask = mask;
+    watch.value = value & mask;
+    watch.callback = callback;
+    watch.context = context;
+    clock_gettime(CLOCK_MONOTONIC, &watch.deadline);
+    ussTimespecAddNs(watch.deadline, (long long)timeoutMs * NSEC_PER_MSEC);
+
+    pthread_mutex_lock(&m_watchLock);
+    n = m_nrWatches[slaveIndex].load(std::memory_order_relaxed);
+
+    if(n == USS_STATUS_WATCHES)
+    {
+        pthread_mutex_unlock(&m_watchLock);
+        return -1;
+    }
+
+    m_watches[slaveIndex][n] = watch;
+    m_nrWatches[slaveIndex].store(n + 1, std::memory_order_relaxed);
+    pthread_mutex_unlock(&m_watchLock);
+
+    return 0;
+}
+
+void USS::checkStatusWatches(const int slaveIndex, const bool valid, const struct timespec &now)
+{
+    statusWatch_t finished[USS_STATUS_WATCHES];
+    int results[USS_STATUS_WATCHES];
+    const uint16_t statusword = m_in.statusword[slaveIndex].load(std::memory_order_relaxed);
+    int nrFinished = 0;
+    int n;
+
+    // the bus never waits for application threads adding watches, they are checked with the next telegram then
+    if(m_nrWatches[slaveIndex].load(std::memory_order_relaxed) == 0 || pthread_mutex_trylock(&m_watchLock) != 0)
+        return;
+
+    n = m_nrWatches[slaveIndex].load(std::memory_order_relaxed);
+
+    for(int i = 0; i < n;)
+    {
+        statusWatch_t &watch = m_watches[slaveIndex][i];
+
+        if(valid && (statusword & watch.mask) == watch.value)
+            results[nrFinished] = 0;
+        else if(ussTimespecDiffNs(watch.deadline, now) <= 0)
+            results[nrFinished] = -1;
+        else
+        {
+            i++;
+            continue;
+        }
+
+        finished[nrFinished++] = watch;
+        watch = m_watches[slaveIndex][--n];
+    }
+
+    m_nrWatches[slaveIndex].store(n, std::memory_order_relaxed);
+    pthread_mutex_unlock(&m_watchLock);
+
+    // called without the lock, so callbacks can add new watches
+    for(int i = 0; i < nrFinished; i++)
+        finished[i].callback(results[i], statusword, finished[i].context);
+}
+
+void USS::lockOutput(const int slaveIndex)
+{
+    uint32_t seq = m_out.seq[slaveIndex].load(std::memory_order_relaxed);
+
+    // odd sequence number means another application thread is writing, writers are only a few stores long
+    do
+    {
+        while(seq & 1)
+            seq = m_out.seq[slaveIndex].load(std::memory_order_relaxed);
+    }
+    while(!m_out.seq[slaveIndex].compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed));
+
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+bool USS::tryLockOutput(const int slaveIndex)
+{
+    uint32_t seq = m_out.seq[slaveIndex].load(std::memory_order_relaxed);
+
+    if((seq & 1) || !m_out.seq[slaveIndex].compare_exchange_strong(seq, seq + 1, std::memory_order_acquire,
+                                                                   std::memory_order_relaxed))
+        return false;
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    return true;
+}
+
+void USS::unlockOutput(const int slaveIndex)
+{
+    m_out.seq[slaveIndex].fetch_add(1, std::memory_order_release);
+}
+
+bool USS::readOutput(const int slaveIndex, uint32_t &seq, uint16_t &ctlword, uint16_t &mainsetpoint,
+                     uint16_t addsetpoint[]) const
+{
+    uint16_t ctl;
+    uint16_t main;
+    uint16_t add[USS_PZD_ADD_SLOTS];
+
+    seq = m_out.seq[slaveIndex].load(std::memory_order_acquire);
+
+    if(seq & 1)
+        return false;
+
+    ctl = m_out.ctlword[slaveIndex].load(std::memory_order_relaxed);
+    main = m_out.mainsetpoint[slaveIndex].load(std::memory_order_relaxed);
+
+    for(int i = 0; i < USS_PZD_ADD_WORDS; i++)
+        add[i] = m_out.addsetpoint[i][slaveIndex].load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if(seq != m_out.seq[slaveIndex].load(std::memory_order_relaxed))
+        return false;
+
+    // the copy is only taken over when it is consistent, otherwise the words of the last cycle are kept
+    ctlword = ctl;
+    mainsetpoint = main;
+
+    for(int i = 0; i < USS_PZD_ADD_WORDS; i++)
+        addsetpoint[i] = add[i];
+
+    return true;
+}
+
+void USS::writeInput(const int slaveIndex, const byte pzd[])
+{
+    uint32_t seq = m_in.seq[slaveIndex].load(std::memory_order_relaxed);
+
+    m_in.seq[slaveIndex].store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_in.statusword[slaveIndex].store(ussGetWord(pzd, 0), std::memory_order_relaxed);
+    m_in.mainactualvalue[slaveIndex].store(ussGetWord(pzd, 2), std::memory_order_relaxed);
+
+    for(int i = 0; i < USS_PZD_ADD_WORDS; i++)
+        m_in.addactualvalue[i][slaveIndex].store(ussGetWord(pzd, 4 + 2 * i), std::memory_order_relaxed);
+
+    m_in.seq[slaveIndex].store(seq + 2, std::memory_order_release);
+}
+
+void USS::readInput(const int slaveIndex, uint16_t &statusword, uint16_t &mainactualvalue,
+                    uint16_t addactualvalue[]) const
+{
+    uint32_t seq;
+
+    do
+    {
+        while((seq = m_in.seq[slaveIndex].load(std::memory_order_acquire)) & 1);
+
+        statusword = m_in.statusword[slaveIndex].load(std::memory_order_relaxed);
+        mainactualvalue = m_in.mainactualvalue[slaveIndex].load(std::memory_order_relaxed);
+
+        for(int i = 0; addactualvalue != nullptr && i < USS_PZD_ADD_WORDS; i++)
+            addactualvalue[i] = m_in.addactualvalue[i][slaveIndex].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    while(seq != m_in.seq[slaveIndex].load(std::memory_order_relaxed));
+}
+
+void USS::publishStats(std::atomic<uint32_t> &seq, std::atomic<uint64_t> words[], const void *stats, const size_t size)
+{
+    uint32_t s = seq.load(std::memory_order_relaxed);
+
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for(size_t i = 0; i * sizeof(uint64_t) < size; i++)
+    {
+        uint64_t word = 0;
+
+        memcpy(&word, static_cast<const byte *>(stats) + i * sizeof(uint64_t),
+               size - i * sizeof(uint64_t) < sizeof(uint64_t) ? size - i * sizeof(uint64_t) : sizeof(uint64_t));
+        words[i].store(word, std::memory_order_relaxed);
+    }
+
+    seq.store(s + 2, std::memory_order_release);
+}
+
+void USS::readStats(const std::atomic<uint32_t> &seq, const std::atomic<uint64_t> words[], void *stats, const size_t size)
+{
+    uint32_t s;
+
+    do
+    {
+        while((s = seq.load(std::memory_order_acquire)) & 1);
+
+        for(size_t i = 0; i * sizeof(uint64_t) < size; i++)
+        {
+            uint64_t word = words[i].load(std::memory_order_relaxed);
+
+            memcpy(static_cast<byte *>(stats) + i * sizeof(uint64_t), &word,
+                   size - i * sizeof(uint64_t) < sizeof(uint64_t) ? size - i * sizeof(uint64_t) : sizeof(uint64_t));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    while(s != seq.load(std::memory_order_relaxed));
+}
+
+void USS::send()
+{
+    struct timespec now;
+    struct timespec cycle = m_nextSend;
+    long jitter;
+
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &m_nextSend, nullptr) == EINTR);
+
+    m_cycleStart = cycle;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    jitter = ussTimespecDiffNs(now, m_nextSend) / NSEC_PER_USEC;
+
+    if(m_cycleStats.cycles > 0)
+    {
+        m_cycleStats.lastPeriod = ussTimespecDiffNs(now, m_lastSend) / NSEC_PER_USEC;
+
+        if(m_cycleStats.cycles == 1 || m_cycleStats.lastPeriod < m_cycleStats.minPeriod)
+            m_cycleStats.minPeriod = m_cycleStats.lastPeriod;
+        if(m_cycleStats.lastPeriod > m_cycleStats.maxPeriod)
+            m_cycleStats.maxPeriod = m_cycleStats.lastPeriod;
+    }
+
+    m_cycleStats.lastJitter = jitter;
+
+    if(jitter > m_cycleStats.maxJitter)
+        m_cycleStats.maxJitter = jitter;
+
+    m_cycleStats.cycles++;
+    m_lastSend = now;
+
+#ifdef USS_RT_ALLOC_CHECK
+    m_cycleStats.allocations = ussAllocations;
+#endif
+
+    if(m_actualSlave == m_nrSlaves)
+        m_actualSlave = 0;
+
+    // slaves in back-off give their telegram to the next slave, only the deadlines of their jobs are checked
+    for(int i = 0; i < m_nrSlaves - 1 && m_timing[m_actualSlave].skip > 0; i++)
+    {
+        m_timing[m_actualSlave].skip--;
+        m_slaveStats[m_actualSlave].skipped++;
+        nextParamJob(m_actualSlave, now);
+        checkStatusWatches(m_actualSlave, false, now);
+        publishStats(m_slaveStatsImage[m_actualSlave].seq, m_slaveStatsImage[m_actualSlave].words,
+                     &m_slaveStats[m_actualSlave], sizeof(m_slaveStats[m_actualSlave]));
+        m_actualSlave = (m_actualSlave + 1) % m_nrSlaves;
+    }
+
+    // next deadline is absolute, so the cycle does not drift with the runtime of send() and receive(), the gap
+    // after the telegram is the spec period or the adaptive one of the slave
+    m_cycleStats.period = m_timing[m_actualSlave].gap;
+    ussTimespecAddNs(m_nextSend, (long long)m_cycleStats.period * NSEC_PER_USEC);
+
+    if(ussTimespecDiffNs(m_nextSend, now) <= 0)
+    {
+        m_cycleStats.overruns++;
+        m_nextSend = now;
+        ussTimespecAddNs(m_nextSend, (long long)m_cycleStats.period * NSEC_PER_USEC);
+    }
+
+    publishStats(m_cycleStatsImage.seq, m_cycleStatsImage.words, &m_cycleStats, sizeof(m_cycleStats));
+
+    // a pending broadcast takes the place of the next cyclic telegram, the round robin continues after it
+    uint64_t broadcast = m_broadcast.exchange(0, std::memory_order_acquire);
+
+    if(broadcast & USS_BROADCAST_PENDING)
+    {
+        m_sendBuffer[USS_ADR_OFFSET] = ADDR_BYTE_BROADCAST_FLAG;
+        memset(m_sendBuffer + USS_PKW_OFFSET, 0, USS_BCC_OFFSET - USS_PKW_OFFSET);
+        ussPutWord(m_sendBuffer, USS_PZD_OFFSET, (broadcast >> 16) & 0xFFFF);
+        ussPutWord(m_sendBuffer, USS_PZD_OFFSET + 2, broadcast & 0xFFFF);
+        m_sendBuffer[USS_BCC_OFFSET] = ussBCC(m_sendBuffer, USS_BCC_OFFSET);
+
+        m_txFailed = transmit(m_sendBuffer) != 0;
+        m_broadcastSent = true;
+
+        return;
+    }
+
+    // points of the trajectory are applied on the deadline and not on the time the thread woke up, so the same
+    // cycles get them on every run
+    if(m_trajectory[m_actualSlave].active.load(std::memory_order_acquire))
+        runTrajectory(m_actualSlave, cycle);
+
+    byte *frame = m_txFrame[m_actualSlave];
+    uint16_t ctlword;
+    uint16_t mainsetpoint;
+    uint16_t addsetpoint[USS_PZD_ADD_SLOTS];
+    uint32_t seq;
+
+    // the PZD words are only patched when the process image of the slave changed since its last telegram,
+    // while an application thread writes it the frame of the last cycle is sent again instead of waiting
+    if(m_out.seq[m_actualSlave].load(std::memory_order_relaxed) != m_txSeq[m_actualSlave] &&
+       readOutput(m_actualSlave, seq, ctlword, mainsetpoint, addsetpoint))
+    {
+        ussPatchWord(frame, USS_PZD_OFFSET, ctlword);
+        ussPatchWord(frame, USS_PZD_OFFSET + 2, mainsetpoint);
+
+        for(int i = 0; i < USS_PZD_ADD_WORDS; i++)
+            ussPatchWord(frame, USS_PZD_ADD_OFFSET + 2 * i, addsetpoint[i]);
+
+        m_txSeq[m_actualSlave] = seq;
+    }
+
+    // parameter jobs of this slave are sent in its cyclic telegrams, one job at a time in queue order
+    nextParamJob(m_actualSlave, now);
+
+    if(USS_PKW_WORDS > 0)
+    {
+        const pkwSlave_t &pkw = m_pkw[m_actualSlave];
+        const bool job = pkw.busy && !pkw.noTask;
+
+        // the words of a job stay the same until it is finished, so they are only patched at its start and end
+        ussPatchWord(frame, USS_PKE_OFFSET, job ? pkw.active.pke : 0);
+        ussPatchWord(frame, USS_IND_OFFSET, job ? pkw.active.ind : 0);
+
+        // word values are in the last PWE word, so only PWE2 is sent with 3 PKW words
+        if(USS_PKW_WORDS == 4)
+            ussPatchWord(frame, USS_PWE_OFFSET, job ? pkw.active.pwe[0] : 0);
+
+        ussPatchWord(frame, USS_PZD_OFFSET - 2, job ? pkw.active.pwe[1] : 0);
+    }
+
+    ussSlaveStats_t &stats = m_slaveStats[m_actualSlave];
+
+    m_txFailed = transmit(frame) != 0;
+    stats.telegrams++;
+
+    if(m_txFailed)
+        stats.txErrors++;
+    else
+        stats.txBytes += USS_BUFFER_LENGTH;
+}
+
+int USS::transmit(const byte telegram[])
+{
+    // the transport switches the bus to receive when the last character is on the wire
+    int ret = m_transport->write(telegram, USS_BUFFER_LENGTH);
+
+    clock_gettime(CLOCK_MONOTONIC, &m_txEnd);
+
+    return ret;
+}
+
+int USS::receive()
+{
+    int ret = 0;
+    int received = 0;
+    struct timespec deadline = m_txEnd;
+    struct timespec now;
+    ussParserStats_t before;
+    ussParserStats_t after;
+    bool valid = false;
+    bool timedOut = m_txFailed;
+    bool otherAddress = false;
+    int length = 0;
+
+    // slaves never answer a broadcast
+    if(m_broadcastSent)
+    {
+        m_broadcastSent = false;
+        return 0;
+    }
+
+    // wait for the response until a complete telegram of the slave is there or the maximum response time after
+    // the end of the telegram is over, a telegram that couldn't be written gets no response
+    ussTimespecAddNs(deadline, m_respTimeout);
+
+    m_parser.getStats(before);
+
+    while(!valid)
+    {
+        length = m_parser.next(m_recvBuffer, USS_MAX_TELEGRAM_LENGTH, timedOut);
+
+        if(length > 0)
+        {
+            // a late response of the slave before or a telegram shorter than the PZD can't be the response
+            if((m_recvBuffer[USS_ADR_OFFSET] & ADDR_BYTE_ADDR_MASK) != (m_slaves[m_actualSlave] & ADDR_BYTE_ADDR_MASK) ||
+               length < TELEGRAM_OVERHEAD_CHARACTERS + PZD_LENGTH_CHARACTERS)
+                otherAddress = true;
+            else
+                valid = true;
+        }
+        else if(timedOut)
+        {
+            break;
+        }
+        else
+        {
+            // the bytes are received straight into the ring buffer of the parser, without copying
+            int space;
+            byte *buffer = m_parser.writeSpace(space);
+            int len = m_transport->read(buffer, space, deadline);
+
+            if(len > 0)
+            {
+                m_parser.commit(len);
+                received += len;
+            }
+            else
+            {
+                // no more bytes, so an incomplete telegram is dropped and searched for a telegram behind it
+                timedOut = true;
+            }
+        }
+    }
+
+    ussSlaveStats_t &stats = m_slaveStats[m_actualSlave];
+
+    m_parser.getStats(after);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    stats.rxBytes += received;
+
+    // write errors are counted in send()
+    if(m_txFailed || valid)
+        ;
+    else if(received == 0)
+        stats.timeouts++;
+    else if(otherAddress)
+        stats.badAddress++;
+    else if(after.bccErrors != before.bccErrors)
+        stats.badBcc++;
+    else if(after.truncated != before.truncated)
+        stats.shortResponses++;
+    else
+        stats.badStx++;
+
+    if(valid)
+    {
+        int bucket = 0;
+
+        stats.responses++;
+        stats.consecutiveFailures = 0;
+        m_timing[m_actualSlave].skip = 0;
+        stats.lastGood = now;
+        stats.lastLatency = ussTimespecDiffNs(now, m_txEnd) / NSEC_PER_USEC;
+
+        if(stats.lastLatency > stats.maxLatency)
+            stats.maxLatency = stats.lastLatency;
+
+        while(bucket < USS_LATENCY_BUCKETS - 1 && stats.lastLatency >= ((long)USS_LATENCY_BUCKET_US << bucket))
+            bucket++;
+
+        stats.latency[bucket]++;
+
+        // PZD is decoded from the end of the telegram, so it is found with any length of the PKW, like for
+        // USS_PKW_LENGTH_VARIABLE set in the slave
+        const int pzdOffset = length - 1 - PZD_LENGTH_CHARACTERS;
+        const int pkwLength = pzdOffset - USS_PKW_OFFSET;
+
+        writeInput(m_actualSlave, m_recvBuffer + pzdOffset);
+
+        pkwSlave_t &pkw = m_pkw[m_actualSlave];
+        uint16_t pke = pkwLength >= 6 ? ussGetWord(m_recvBuffer, USS_PKE_OFFSET) : 0;
+        uint16_t ind = pkwLength >= 6 ? ussGetWord(m_recvBuffer, USS_IND_OFFSET) : 0;
+        uint32_t pwe = pkwLength >= 6 ? ussGetWord(m_recvBuffer, pzdOffset - 2) : 0;
+
+        if(pkwLength >= 8)
+            pwe |= (uint32_t)ussGetWord(m_recvBuffer, pzdOffset - 4) << 16;
+
+        // the job itself is sent with the next telegram, once the slave answered the no task
+        if(pkw.busy && pkw.noTask)
+        {
+            if(pkwLength < 6 || (pke & PKE_WORD_AK_MASK) == PKE_WORD_AK_NO_RESP)
+                pkw.noTask = false;
+        }
+        // the slave answers with the old response until it processed the job, so only a response that fits
+        // parameter number, index, AK and for writes the value finishes it
+        else if(pkwLength >= 6 && pkw.busy && paramResponseMatches(pkw.active, pke, ind, pwe))
+        {
+            switch(pke & PKE_WORD_AK_MASK)
+            {
+                case PKE_WORD_AK_TRW_PWE:
+                    finishParamJob(m_actualSlave, 0, pwe & 0xFFFF);
+                    break;
+
+                case PKE_WORD_AK_TRD_PWE:
+                    finishParamJob(m_actualSlave, 0, pwe);
+                    break;
+
+                case PKE_WORD_AK_NO_RIGHTS:
+                    ret = USS_PKW_ERR_NO_RIGHTS;
+                    finishParamJob(m_actualSlave, ret, 0);
+                    break;
+
+                case PKE_WORD_AK_CANT_EXECUTE:
+                    ret = pwe & 0xFFFF;
+
+                    if(!ret)
+                        ret = USS_PKW_ERR_ILLEGAL_PARAM;   // 0 is error code for illegal parameter number
+
+                    finishParamJob(m_actualSlave, ret, 0);
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+    else
+    {
+        pkwSlave_t &pkw = m_pkw[m_actualSlave];
+
+        ret = -1;
+
+        if(++stats.consecutiveFailures > stats.maxConsecutiveFailures)
+            stats.maxConsecutiveFailures = stats.consecutiveFailures;
+
+        // a slave that stopped answering is left out of 1, 2, 4 ... rounds, so it costs a response timeout only
+        // every USS_BACKOFF_MAX_SKIP + 1 rounds and the other slaves keep their cycle
+        if(stats.consecutiveFailures >= USS_BACKOFF_FAILURES)
+        {
+            const unsigned long shift = stats.consecutiveFailures - USS_BACKOFF_FAILURES;
+
+            m_timing[m_actualSlave].skip = shift < 16 && (1UL << shift) < USS_BACKOFF_MAX_SKIP ? 1UL << shift : USS_BACKOFF_MAX_SKIP;
+        }
+
+        // the job fails with the reason of its last failure, when its deadline or its retries are over
+        if(pkw.busy)
+            pkw.active.error = received > 0 ? USS_PKW_ERR_BAD_RESPONSE : USS_PKW_ERR_TIMEOUT;
+
+        if(pkw.busy && pkw.active.retries >= 0 && ++pkw.active.tries > pkw.active.retries)
+            finishParamJob(m_actualSlave, pkw.active.error, 0);
+    }
+
+    checkStatusWatches(m_actualSlave, valid, now);
+    updateTiming(m_actualSlave, valid, stats.lastLatency);
+
+    if(m_recorder != nullptr)
+    {
+        ussTelemetrySample_t sample;
+
+        sample.timeNs = (uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+        sample.cycle = m_cycleStats.cycles;
+        sample.slave = m_actualSlave;
+        sample.valid = valid;
+        sample.statusword = m_in.statusword[m_actualSlave].load(std::memory_order_relaxed);
+        sample.mainactualvalue = m_in.mainactualvalue[m_actualSlave].load(std::memory_order_relaxed);
+        sample.ctlword = ussGetWord(m_txFrame[m_actualSlave], USS_PZD_OFFSET);
+        sample.mainsetpoint = ussGetWord(m_txFrame[m_actualSlave], USS_PZD_OFFSET + 2);
+        sample.reserved = 0;
+        m_recorder->push(sample);
+    }
+
+    publishStats(m_slaveStatsImage[m_actualSlave].seq, m_slaveStatsImage[m_actualSlave].words, &stats, sizeof(stats));
+
     m_actualSlave++;
 
     return ret;
@@ -38,145 +38,217 @@
 #define USS_H
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <unistd.h>
 #include <time.h>
 #include <string.h>
-//HINT: Make sure you installed pigpio c Library on raspberry pi before using this lib
-#include <pigpio.h>
+#include <pthread.h>
+#include <atomic>
+
+#include "USSProtocol.h"
+#include "USSParser.h"
+
+// arrays of the additional words keep one unused word without additional words
+constexpr int USS_PZD_ADD_SLOTS = USS_PZD_ADD_WORDS > 0 ? USS_PZD_ADD_WORDS : 1;
+
+/**
+ * @brief Parameter (PKW) jobs, queue length per slave and defaults for deadline and retries
+ */
+#define USS_PKW_QUEUE_LENGTH       32
+#define USS_PKW_TIMEOUT_MS         10000
+#define USS_PKW_RETRIES_UNLIMITED  -1
+
+/**
+ * @brief Number of status word watches per slave
+ */
+#define USS_STATUS_WATCHES         16
+
+/**
+ * @brief Results of parameter jobs, positive results are the error number of the slave for AK 7 (can't execute)
+ */
+#define USS_PKW_OK                 0
+#define USS_PKW_ERR_TIMEOUT        -1      // no response until the deadline or the retries were over
+#define USS_PKW_ERR_NO_RIGHTS      -2      // AK 8, no rights to change the parameter
+#define USS_PKW_ERR_ILLEGAL_PARAM  -3      // AK 7 with error number 0, illegal parameter number
+#define USS_PKW_ERR_BAD_RESPONSE   -4      // the slave answered, but the last response was corrupted (BCC, length, address)
+#define USS_PKW_ERR_NOT_QUEUED     -5      // the job wasn't queued, illegal slave index or queue of the slave full
+
+/**
+ * @brief Back-off of slaves that don't answer, after USS_BACKOFF_FAILURES failed responses in a row the slave is
+ *        left out of 1, 2, 4 ... up to USS_BACKOFF_MAX_SKIP rounds of the other slaves before it is polled again
+ */
+#define USS_BACKOFF_FAILURES       3
+#define USS_BACKOFF_MAX_SKIP       32
+
+/**
+ * @brief Flag for a broadcast waiting to be sent, above the control word and setpoint in m_broadcast
+ */
+#define USS_BROADCAST_PENDING      (1ULL << 32)
+
+/**
+ * @brief Parameter cache, entries per slave and max age values for getParameter()
+ */
+#define USS_PARAM_CACHE_LENGTH     32
+#define USS_PARAM_CACHE_ANY_AGE    -1
+#define USS_PARAM_CACHE_BYPASS     0
+
 /**
- * @brief STX start byte
+ * @brief Max number of points of a setpoint trajectory per slave, can be set at compile time
+ *        (-DUSS_TRAJECTORY_LENGTH=...)
  */
-#define STX_BYTE_STX               0x02
+#ifndef USS_TRAJECTORY_LENGTH
+#define USS_TRAJECTORY_LENGTH      64
+#endif
 
 /**
- * @brief Define for empty parameter value to check if parameter was written on the bus
+ * @brief Real-time mode of the bus master thread, stack size of the thread and part of it prefaulted before the
+ *        first cycle. With -DUSS_RT_ALLOC_CHECK allocations with new in the bus thread are counted.
  */
-#define PARAM_VALUE_EMPTY          0xA000
+#define USS_RT_STACK_SIZE          (256 * 1024)
+#define USS_RT_STACK_PREFAULT      (64 * 1024)
 
 /**
- * @brief Flags in USS address byte (address has only 5 bits)
+ * @brief Time units for the timespec helpers
  */
-#define ADDR_BYTE_BROADCAST_FLAG   0x20
-#define ADDR_BYTE_MIRROR_FLAG      0x40
-#define ADDR_BYTE_SPECIAL_FLAG     0x80
+#define NSEC_PER_SEC               1000000000L
+#define NSEC_PER_MSEC              1000000L
+#define NSEC_PER_USEC              1000L
 
 /**
- * @brief Bitmasks for PKE field and address byte
+ * @brief Add nanoseconds to a timespec and normalize it
  */
-#define ADDR_BYTE_ADDR_MASK        0x1F
-#define PKE_WORD_PARAM_MASK        0x7FF
-#define PKE_WORD_SP_FLAG           0x800
-#define PKE_WORD_AK_MASK           0xF000
-#define PKE_WORD_AK_NO_TASK        0x0000
-#define PKE_WORD_AK_REQ_PWE        0x1000
-#define PKE_WORD_AK_CHW_PWE        0x2000
-#define PKE_WORD_AK_CHD_PWE        0x3000
+inline void ussTimespecAddNs(struct timespec &ts, const long long ns)
+{
+    long long nsec = ts.tv_nsec + ns;
+
+    ts.tv_sec += nsec / NSEC_PER_SEC;
+    ts.tv_nsec = nsec % NSEC_PER_SEC;
+
+    if(ts.tv_nsec < 0)
+    {
+        ts.tv_sec--;
+        ts.tv_nsec += NSEC_PER_SEC;
+    }
+}
 
 /**
- * @brief Response code for PKE operations
+ * @brief Difference a - b of two timespecs in nanoseconds
  */
-#define PKE_WORD_AK_NO_RESP        0x0000
-#define PKE_WORD_AK_TRW_PWE        0x1000
-#define PKE_WORD_AK_TRD_PWE        0x2000
-#define PKE_WORD_AK_NO_RIGHTS      0x8000
-#define PKE_WORD_AK_CANT_EXECUTE   0x7000
+inline long long ussTimespecDiffNs(const struct timespec &a, const struct timespec &b)
+{
+    return (long long)(a.tv_sec - b.tv_sec) * NSEC_PER_SEC + (a.tv_nsec - b.tv_nsec);
+}
 
 /**
- * @brief Control word flags and descriptions
+ * @struct structure definition for timing statistics of the bus cycle, all times in microseconds
  */
-#define CTL_WORD_ON_OFF1_FLAG      0x0001
-#define CTL_WORD_ON_OFF1_OFF1      0x0000
-#define CTL_WORD_ON_OFF1_ON        0x0001
-#define CTL_WORD_OFF2_FLAG         0x0002
-#define CTL_WORD_OFF2_OFF2         0x0000
-#define CTL_WORD_OFF2_OP_COND      0x0002
-#define CTL_WORD_OFF3_FLAG         0x0004
-#define CTL_WORD_OFF3_OFF3         0x0000
-#define CTL_WORD_OFF3_OP_COND      0x0004
-#define CTL_WORD_ENABLE_FLAG       0x0008
-#define CTL_WORD_ENABLE_INHIBIT    0x0000
-#define CTL_WORD_ENABLE_ENABLE     0x0008
-#define CTL_WORD_INHIBIT_RAMP_FLAG       0x0010
-#define CTL_WORD_INHIBIT_RAMP_INHIBIT    0x0000
-#define CTL_WORD_INHIBIT_RAMP_OP_COND    0x0010
-#define CTL_WORD_ENABLE_RAMP_FLAG        0x0020
-#define CTL_WORD_ENABLE_RAMP_HOLD        0x0000
-#define CTL_WORD_ENABLE_RAMP_ENABLE      0x0020
-#define CTL_WORD_ENABLE_SETPOINT_FLAG    0x0040
-#define CTL_WORD_ENABLE_SETPOINT_INHIBIT 0x0000
-#define CTL_WORD_ENABLE_SETPOINT_ENABLE  0x0040
-#define CTL_WORD_ACK_FLAG          0x0080
-#define CTL_WORD_CTL_PLC_FLAG      0x0400
-#define CTL_WORD_CTL_PLC_NO_CTL    0x0000
-#define CTL_WORD_CTL_PLC_CTL_PLC   0x0400
+typedef struct
+{
+    unsigned long cycles;       // number of telegrams sent since begin()
+    unsigned long overruns;     // number of cycles that started later than the following deadline
+    long period;                // time from the last telegram to the next one, spec or adaptive timing
+    long lastPeriod;            // measured time between the last two telegrams
+    long minPeriod;
+    long maxPeriod;
+    long lastJitter;            // delay of the last telegram after its deadline
+    long maxJitter;
+    long lastRuntime;           // time from the deadline to the end of the response, of the last cycle
+    long maxRuntime;            // worst case of it, must stay below the period
+    unsigned long allocations;  // allocations in the bus thread, only counted with USS_RT_ALLOC_CHECK
+} ussCycleStats_t;
 
 /**
- * @brief Status word flags and descriptions
+ * @struct structure definition for the execution mode of the bus master thread
  */
-#define STATUS_WORD_SWITCH_READY_FLAG           0x0001
-#define STATUS_WORD_SWITCH_READY                0x0001
-#define STATUS_WORD_SWITCH_NOT_READY            0x0000
-#define STATUS_WORD_READY_FLAG                  0x0002
-#define STATUS_WORD_READY                       0x0002
-#define STATUS_WORD_NOT_READY                   0x0000
-#define STATUS_WORD_OP_ENABLED_FLAG             0x0004
-#define STATUS_WORD_OP_ENABLED_ENABLED          0x0004
-#define STATUS_WORD_OP_ENABLED_INHIBIT          0x0000
-#define STATUS_WORD_FAULT_FLAG                  0x0008
-#define STATUS_WORD_FAULT_FAULT                 0x0008
-#define STATUS_WORD_FAULT_FAUlT_FREE            0x0000
-#define STATUS_WORD_OFF2_FLAG                   0x0010
-#define STATUS_WORD_OFF2_NO_OFF2                0x0010
-#define STATUS_WORD_OFF2_OFF2                   0x0000
-#define STATUS_WORD_OFF3_FLAG                   0x0020
-#define STATUS_WORD_OFF3_NO_OFF3                0x0020
-#define STATUS_WORD_OFF3_OFF3                   0x0000
-#define STATUS_WORD_SWITCH_INHIBIT_FLAG         0x0040
-#define STATUS_WORD_SWITCH_INHIBIT_INHIBIT      0x0040
-#define STATUS_WORD_SWITCH_INHIBIT_NO_INHIBIT   0x0000
-#define STATUS_WORD_ALARM_FLAG                  0x0080
-#define STATUS_WORD_ALARM_ALARM                 0x0080
-#define STATUS_WORD_ALARM_NO_ALARM              0x0000
-#define STATUS_WORD_SETPOINT_TOL_FLAG           0x0100
-#define STATUS_WORD_SETPOINT_TOL_IN_RANGE       0x0100
-#define STATUS_WORD_SETPOINT_TOL_NOT_IN_RANGE   0x0000
-#define STATUS_WORD_CTL_REQ_FLAG                0x0200
-#define STATUS_WORD_CTL_REQ_CTL_REQ             0x0200
-#define STATUS_WORD_CTL_REQ_LOCAL_OP            0x0000
-#define STATUS_WORD_F_N_REACHED_FLAG            0x0400
-#define STATUS_WORD_F_N_REACHED_REACHED         0x0400
-#define STATUS_WORD_F_N_REACHED_FALLEN_BELOW    0x0000
+typedef struct
+{
+    int cpu;                    // CPU core the thread is pinned to, -1 to let the scheduler choose
+    int priority;               // SCHED_FIFO priority 1 to 99, 0 for the normal scheduler
+    bool lockMemory;            // lock all memory of the process and prefault the stack of the thread
+} ussRtConfig_t;
 
 /**
- * @brief Max number of USS Slaves
+ * @struct structure definition for the adaptive timing of the bus, the time from the telegram to a slave to the next
+ *         telegram is shortened from the spec value to the measured response latency of the slave plus a margin
  */
-#define USS_SLAVES                 2
+typedef struct
+{
+    int percentile;             // percentile of the latencies the gap is based on, 1 to 100, 0 for the spec timing
+    long marginUs;              // added to the latency, covers the runtime of the master and the start pause
+    int maxFailures;            // failed responses of a slave within USS_TIMING_SAMPLES telegrams that switch it
+                                // back to the spec timing until it is measured again
+} ussTimingConfig_t;
 
 /**
- * @brief number of PZD and PKW fields and length in bytes
+ * @brief Number of latencies of a slave the percentile is taken from, the gap is updated after each of them
  */
-#define PZD_ANZ                    1
-#define PZD_LENGTH_CHARACTERS      4
-#define PKW_ANZ                    1
-#define PKW_LENGTH_CHARACTERS      8
+#define USS_TIMING_SAMPLES         64
 
 /**
- * @brief USS parameters
+ * @brief Buckets of the response latency histogram, bucket 0 counts latencies below USS_LATENCY_BUCKET_US, bucket n
+ *        latencies below USS_LATENCY_BUCKET_US << n and the last bucket all longer ones
  */
-#define CHARACTER_RUNTIME_BASE_US  1150
-#define BAUDRATE_BASE              9600
-#define MAX_RESP_DELAY_TIME_MS     20
-#define MASTER_COMPUTE_DELAY_MS    20
-#define START_DELAY_LENGTH_CHARACTERS 2
-#define TELEGRAM_OVERHEAD_CHARACTERS 4
+#define USS_LATENCY_BUCKETS        16
+#define USS_LATENCY_BUCKET_US      100
 
-#define USS_BUFFER_LENGTH               (TELEGRAM_OVERHEAD_CHARACTERS + (PKW_LENGTH_CHARACTERS * PKW_ANZ) + (PZD_LENGTH_CHARACTERS * PZD_ANZ))
+/**
+ * @struct structure definition for the statistics of one slave, all times in microseconds
+ */
+typedef struct
+{
+    unsigned long telegrams;            // telegrams sent to the slave, broadcasts are not counted
+    unsigned long txBytes;
+    unsigned long rxBytes;
+    unsigned long responses;            // valid responses
+    unsigned long txErrors;             // telegram couldn't be written to the serial device
+    unsigned long timeouts;             // no character received within the response time
+    unsigned long shortResponses;       // response incomplete when the response time was over
+    unsigned long badStx;               // first character isn't STX
+    unsigned long badAddress;           // response from another slave
+    unsigned long badBcc;
+    unsigned long consecutiveFailures;  // telegrams without valid response since the last valid one
+    unsigned long maxConsecutiveFailures;
+    struct timespec lastGood;           // time of the last valid response on CLOCK_MONOTONIC, 0 before the first
+    long lastLatency;                   // from the end of the telegram to the complete response
+    long maxLatency;
+    unsigned long latency[USS_LATENCY_BUCKETS];
+    long gap;                           // time from the telegram to the slave to the next telegram
+    unsigned long timingFallbacks;      // switches back to the spec timing because of failed responses
+    unsigned long skipped;              // telegrams left out by the back-off of a slave that doesn't answer
+} ussSlaveStats_t;
+
+/**
+ * @brief Callback for finished parameter jobs, called from the thread running send() and receive()
+ *
+ * @param result USS error code, like the return value of setParameter()
+ * @param param Parameter number of the job
+ * @param value Parameter value of the response, 0 on error
+ * @param context User pointer given with the job
+ */
+typedef void (*ussParamCallback_t)(const int result, const uint16_t param, const uint32_t value, void *context);
 
-// custom data types
-typedef unsigned char byte;
-typedef unsigned char uint8_t;
-typedef unsigned short uint16_t;
-typedef unsigned int uint32_t ;
+/**
+ * @brief Callback for status word watches, called from the thread running send() and receive()
+ *
+ * @param result 0 when the status word matched, -1 when the deadline was over before
+ * @param statusword Status word of the last valid response of the slave
+ * @param context User pointer given with the watch
+ */
+typedef void (*ussStatusCallback_t)(const int result, const uint16_t statusword, void *context);
+
+/**
+ * @struct structure definition for one point of a setpoint trajectory, in the units of the telegram
+ */
+typedef struct
+{
+    uint32_t timeMs;                // time of the point from the start of the trajectory
+    uint16_t setFlags;              // flags set in the control word
+    uint16_t clearFlags;            // flags cleared from the control word, before setFlags are set
+    uint16_t mainsetpoint;
+} ussTrajectoryPoint_t;
+
+class USSTransport;
+class USSTelemetry;
 
 class USS
 {
@@ -190,27 +262,135 @@ class USS
      */
     USS();
 
+    /**
+     * @brief Destructor for USS class, closes the serial device
+     */
+    ~USS();
+
     /**
      * @brief Function to configure the USS instance, called in setup of arduino sketch
      * @param *sertty the serial device to open ex: "/dev/ttyS0" ,"/dev/serial" . "/dev/USB0"
      * @param speed Baudrate of serial peripheral used for USS communication
-     * @param slaves array with USS slave addresses that are on the bus
-     * @param nrSlaves Number fo USS slaves on the bus
-     * @param dePin Driver enable pin for RS485 level converters that need it (like MAX485)
+     * @param slaves array with USS slave addresses that are on the bus, addresses 0 to 31 and each only once
+     * @param nrSlaves Number fo USS slaves on the bus, 1 to USS_SLAVES
+     * @param dePin Driver enable pin for RS485 level converters that need it (like MAX485), -1 for converters
+     *              that switch direction on their own (like most RS485/USB modules)
      * @retval 0: success
      * @retval -1: failure
+     *
+     * Uses the pigpio transport (USSPigpioTransport) and is implemented in USSPigpioTransport.cpp, so it is only
+     * available where pigpio is installed.
+     */
+    int begin(const char *sertty, unsigned int speed, const char slaves[], const int nrSlaves, const int dePin);
+
+    /**
+     * @brief Function to configure the USS instance with a transport backend for the serial device
+     * @param transport backend for the serial device, like USSTermiosTransport or USSRS485Transport, it stays
+     *                  owned by the caller and must live as long as the USS instance
+     * @param *sertty the serial device to open ex: "/dev/ttyS0" ,"/dev/serial" . "/dev/USB0"
+     * @param speed Baudrate of serial peripheral used for USS communication
+     * @param slaves array with USS slave addresses that are on the bus, addresses 0 to 31 and each only once
+     * @param nrSlaves Number fo USS slaves on the bus, 1 to USS_SLAVES
+     * @retval 0: success
+     * @retval -1: failure
+     */
+    int begin(USSTransport *transport, const char *sertty, unsigned int speed, const char slaves[], const int nrSlaves);
+
+
+    /**
+     * @brief Get timing statistics of the bus cycle scheduler
+     *
+     * @param stats structure the actual statistics are copied to
+     * @return none
+     *
+     * Period and jitter are measured on CLOCK_MONOTONIC at every send(). Jitter is the delay between the
+     * scheduled deadline and the actual start of the telegram. An overrun is counted when a cycle started so
+     * late that the following deadline was already over, the schedule is then restarted from the actual time.
+     */
+    void getCycleStats(ussCycleStats_t &stats) const;
+
+    /**
+     * @brief Get the statistics of one slave
+     *
+     * @param stats structure the actual statistics are copied to
+     * @param slaveIndex index in array of slave addresses used on creation of USS instance
+     * @retval 0: success
+     * @retval -1: illegal slave index
+     *
+     * The bus thread publishes the statistics after every response without locks, the copy is taken
+     * consistently from the values of one cycle, so a monitoring thread can poll it without slowing the bus.
+     */
+    int getSlaveStats(ussSlaveStats_t &stats, const int slaveIndex) const;
+
+    /**
+     * @brief Start the bus master thread, which calls send() and receive() cyclically
+     *
+     * @param cpu CPU core the thread is pinned to, -1 to let the scheduler choose
+     * @retval 0: success
+     * @retval -1: failure, begin() not called successfully, thread already running or illegal cpu
+     *
+     * While the thread runs, the application must not call send() and receive() itself. Control words and
+     * setpoints are written and status words and actual values are read through the process image, so
+     * application threads never block on serial I/O and application code can never stall the bus.
+     */
+    int startCyclic(const int cpu = -1);
+
+    /**
+     * @brief Start the bus master thread in real-time mode
+     *
+     * @param config CPU core, SCHED_FIFO priority and memory locking of the thread
+     * @retval 0: success
+     * @retval -1: failure, like startCyclic() with a CPU core
+     * @retval -2: no permission for the real-time priority or for locking the memory (CAP_SYS_NICE,
+     *             CAP_IPC_LOCK or RLIMIT_RTPRIO/RLIMIT_MEMLOCK)
+     *
+     * All buffers and queues are members of the instance, allocated with it and not in the cycle. With
+     * lockMemory the memory of the whole process is locked (mlockall()) and kept by malloc, so neither the bus
+     * thread nor the application threads writing the process image are delayed by page faults. The worst case
+     * of wake up latency and cycle runtime is reported in the cycle statistics to check the timing budget.
+     */
+    int startCyclic(const ussRtConfig_t &config);
+
+    /**
+     * @brief Stop the bus master thread, returns after the running cycle is finished
+     *
+     * @return none
      */
-    int begin(char *sertty, unsigned int speed, const char slaves[], const int nrSlaves, const int dePin);
+    void stopCyclic();
 
+    /**
+     * @brief Is the bus master thread running?
+     *
+     * @return boolean is the bus master thread running?
+     */
+    bool cyclicRunning() const;
 
-	/**
-	 *  function to measure to elapsed time since USS started
-	 * @param start
-	 * @param stop
-	 * @return  measure time for each uss::send
-	 */
+    /**
+     * @brief Record the process data of every telegram
+     *
+     * @param recorder opened telemetry log the bus thread pushes a sample to after every response or timeout,
+     *                 nullptr stops recording
+     * @return none
+     *
+     * Set it before startCyclic() or while no cycle runs, the recorder must stay open while it is set.
+     */
+    void setRecorder(USSTelemetry *recorder);
 
-	double millis(double start,double stop);
+    /**
+     * @brief Set the timing of the bus
+     *
+     * @param config adaptive timing with percentile and margin, percentile 0 for the fixed spec timing
+     * @retval 0: success
+     * @retval -1: percentile above 100 or negative margin or failures
+     *
+     * The spec timing waits the worst case response delay of MAX_RESP_DELAY_TIME_MS and MASTER_COMPUTE_DELAY_MS after
+     * every telegram. In adaptive timing the telegram to a slave is followed by the next one after the telegram
+     * runtime, the percentile of the last USS_TIMING_SAMPLES response latencies of the slave and the margin, never
+     * later than with the spec timing. A slave starts with the spec timing until it answered USS_TIMING_SAMPLES times.
+     * The response timeout stays the spec value, a late response delays the next telegram only.
+     * Set it before startCyclic() or while no cycle runs, the measurement of all slaves starts again.
+     */
+    int setTiming(const ussTimingConfig_t &config);
 
     /**
      * @brief Set parameter as word value (2 byte) to a given USS slave
@@ -221,13 +401,23 @@ class USS
      *              on the USS bus and therefore defined in a higher layer
      * @param slaveIndex Index of the slave the parameter should be set, index number acording to pslaves array
      *                   from begin()
+     * @param timeoutMs Deadline of the call in ms from now, including the time the job waits in the queue
+     * @param retries Number of telegrams without valid response before the call fails, USS_PKW_RETRIES_UNLIMITED
+     *                to only use the deadline
      * @return USS error code
      * @retval 0: success
-     * @retval -1: no response
+     * @retval -1: no response until the deadline or the retries were over, illegal slave index or queue full
      * @retval -2: access denied
      * @retval -3: illegal parameter number
+     * @retval -4: the slave answered, but the last response was corrupted
+     * @retval >0: the slave can't execute the job, error number of the slave
+     *
+     * Blocks until the job queued with setParameterAsync() is finished, never longer than timeoutMs. A slave that
+     * doesn't answer is polled with back-off, so waiting for it costs the bus a bounded time. Retries count the
+     * telegrams actually sent to the slave, so in back-off they take longer and the deadline bounds the wait.
      */
-    int setParameter(const uint16_t param, const uint16_t value, const int slaveIndex);
+    int setParameter(const uint16_t param, const uint16_t value, const int slaveIndex,
+                     const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
 
     /**
      * @brief Set parameter as double word value (4 byte) to a given USS slave
@@ -238,13 +428,12 @@ class USS
      *              on the USS bus and therefore defined in a higher layer
      * @param slaveIndex Index of the slave the parameter should be set, index number acording to pslaves array
      *                   from begin()
-     * @return USS error code
-     * @retval 0: success
-     * @retval -1: no response
-     * @retval -2: access denied
-     * @retval -3: illegal parameter number
+     * @param timeoutMs Deadline of the call in ms from now
+     * @param retries Number of telegrams without valid response before the call fails
+     * @return USS error code like setParameter() for word values
      */
-    int setParameter(const uint16_t param, const uint32_t value, const int slaveIndex);
+    int setParameter(const uint16_t param, const uint32_t value, const int slaveIndex,
+                     const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
 
     /**
      * @brief Set parameter as float (single precision) to a given USS slave
@@ -255,13 +444,184 @@ class USS
      *              on the USS bus and therefore defined in a higher layer
      * @param slaveIndex Index of the slave the parameter should be set, index number acording to pslaves array
      *                   from begin()
-     * @return USS error code
-     * @retval 0: success
-     * @retval -1: no response
-     * @retval -2: access denied
-     * @retval -3: illegal parameter number
+     * @param timeoutMs Deadline of the call in ms from now
+     * @param retries Number of telegrams without valid response before the call fails
+     * @return USS error code like setParameter() for word values
+     */
+    int setParameter(const uint16_t param, const float value, const int slaveIndex,
+                     const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Queue a parameter job to set a word value (2 byte) to a given USS slave without blocking
+     *
+     * @param param Parameter number to set, specific to the concrete device on the USS bus
+     * @param value Parameter value to set as word (2 byte)
+     * @param slaveIndex Index of the slave the parameter should be set, index number acording to pslaves array
+     *                   from begin()
+     * @param callback Function called when the job is finished, may be nullptr
+     * @param context User pointer passed to the callback
+     * @param timeoutMs Deadline of the job in ms from now, the job fails with -1 when it is over
+     * @param retries Number of telegrams without valid response before the job fails with -1 or -4,
+     *                USS_PKW_RETRIES_UNLIMITED to only use the deadline
+     * @retval 0: job queued
+     * @retval -1: illegal slave index, queue of the slave is full or no PKW words in the telegram
+     *
+     * Every slave has its own queue of USS_PKW_QUEUE_LENGTH jobs, which are sent one after another in the cyclic
+     * telegrams of this slave. Jobs of one slave never delay the telegrams to other slaves. The result is
+     * reported to the callback with the error codes of setParameter().
+     */
+    int setParameterAsync(const uint16_t param, const uint16_t value, const int slaveIndex,
+                          ussParamCallback_t callback = nullptr, void *context = nullptr,
+                          const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Queue a parameter job to set a word value (2 byte) of an indexed parameter without blocking
+     *
+     * @param index Parameter index, like for getParameter()
+     *
+     * Other parameters and return values like setParameterAsync() for word values
+     */
+    int setParameterIndexAsync(const uint16_t param, const uint16_t index, const uint16_t value, const int slaveIndex,
+                               ussParamCallback_t callback = nullptr, void *context = nullptr,
+                               const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Queue a parameter job to set a double word value (4 byte) to a given USS slave without blocking
+     *
+     * Parameters and return values like setParameterAsync() for word values
+     */
+    int setParameterAsync(const uint16_t param, const uint32_t value, const int slaveIndex,
+                          ussParamCallback_t callback = nullptr, void *context = nullptr,
+                          const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Queue a parameter job to set a float (single precision) to a given USS slave without blocking
+     *
+     * Parameters and return values like setParameterAsync() for word values
+     */
+    int setParameterAsync(const uint16_t param, const float value, const int slaveIndex,
+                          ussParamCallback_t callback = nullptr, void *context = nullptr,
+                          const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Queue a parameter job to set a double word value (4 byte) of an indexed parameter without blocking
+     *
+     * Parameters and return values like setParameterIndexAsync() for word values
+     */
+    int setParameterIndexAsync(const uint16_t param, const uint16_t index, const uint32_t value, const int slaveIndex,
+                               ussParamCallback_t callback = nullptr, void *context = nullptr,
+                               const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Queue a parameter job to set a float (single precision) of an indexed parameter without blocking
+     *
+     * Parameters and return values like setParameterIndexAsync() for word values
+     */
+    int setParameterIndexAsync(const uint16_t param, const uint16_t index, const float value, const int slaveIndex,
+                               ussParamCallback_t callback = nullptr, void *context = nullptr,
+                               const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Get parameter as word value (2 byte) from a given USS slave
+     *
+     * @param param Parameter number to get, these are specific to the concrete device (like inverter model)
+     *              on the USS bus and therefore defined in a higher layer
+     * @param value Reference the parameter value is written to on success
+     * @param slaveIndex Index of the slave the parameter should be get from, index number acording to pslaves
+     *                   array from begin()
+     * @param index Parameter index for indexed parameters
+     * @param maxAgeMs Max age in ms of a cached value to use it, USS_PARAM_CACHE_ANY_AGE to use cached values
+     *                 until they are invalidated, USS_PARAM_CACHE_BYPASS to always read from the slave
+     * @param timeoutMs Deadline of the call in ms from now
+     * @param retries Number of telegrams without valid response before the call fails
+     * @return USS error code like setParameter()
+     *
+     * Every value read or written successfully is cached per slave, parameter number and index. When a cached
+     * value is young enough it is returned without any telegram, otherwise blocks until the slave answered.
+     */
+    int getParameter(const uint16_t param, uint16_t &value, const int slaveIndex, const uint16_t index = 0,
+                     const int maxAgeMs = USS_PARAM_CACHE_ANY_AGE, const int timeoutMs = USS_PKW_TIMEOUT_MS,
+                     const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Get parameter as double word value (4 byte) from a given USS slave
+     *
+     * Parameters and return values like getParameter() for word values
+     */
+    int getParameter(const uint16_t param, uint32_t &value, const int slaveIndex, const uint16_t index = 0,
+                     const int maxAgeMs = USS_PARAM_CACHE_ANY_AGE, const int timeoutMs = USS_PKW_TIMEOUT_MS,
+                     const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Get parameter as float (single precision) from a given USS slave
+     *
+     * Parameters and return values like getParameter() for word values
+     */
+    int getParameter(const uint16_t param, float &value, const int slaveIndex, const uint16_t index = 0,
+                     const int maxAgeMs = USS_PARAM_CACHE_ANY_AGE, const int timeoutMs = USS_PKW_TIMEOUT_MS,
+                     const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Queue a parameter job to read a value (AK 1) from a given USS slave without blocking
+     *
+     * @param param Parameter number to read
+     * @param slaveIndex Index of the slave, index number acording to pslaves array from begin()
+     * @param index Parameter index for indexed parameters
+     * @param callback Function called with the value when the job is finished, may be nullptr
+     * @param context User pointer passed to the callback
+     * @param timeoutMs Deadline of the job in ms from now
+     * @param retries Number of telegrams without valid response before the job fails
+     * @retval 0: job queued
+     * @retval -1: illegal slave index, queue of the slave is full or no PKW words in the telegram
+     *
+     * Always reads from the slave and updates the cache with the value.
+     */
+    int getParameterAsync(const uint16_t param, const int slaveIndex, const uint16_t index = 0,
+                          ussParamCallback_t callback = nullptr, void *context = nullptr,
+                          const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Invalidate all cached parameter values of a slave
+     *
+     * @param slaveIndex Index of the slave, -1 for all slaves
+     * @return none
+     */
+    void invalidateParameterCache(const int slaveIndex);
+
+    /**
+     * @brief Invalidate the cached value of one parameter, for parameters the slave changes on its own
+     *
+     * @param param Parameter number
+     * @param index Parameter index
+     * @param slaveIndex Index of the slave
+     * @return none
+     */
+    void invalidateParameter(const uint16_t param, const uint16_t index, const int slaveIndex);
+
+    /**
+     * @brief Get number of slaves of the interface
+     *
+     * @return number of slaves given to begin()
      */
-    int setParameter(const uint16_t param, const float value, const int slaveIndex);
+    int nrSlaves() const;
+
+    /**
+     * @brief Get number of parameter jobs of a slave that are not finished yet
+     *
+     * @param slaveIndex Index of the slave, index number acording to pslaves array from begin()
+     * @return number of queued and running jobs, -1 on illegal slave index
+     */
+    int pendingParameters(const int slaveIndex) const;
+
+    /**
+     * @brief Wait until the parameter jobs of all slaves are finished
+     *
+     * @return none
+     *
+     * Runs send() and receive() itself when the bus master thread is not running. Jobs of different slaves
+     * run in parallel, so the time is given by the slave with the most jobs.
+     */
+    void flushParameters();
 
     /**
      * @brief Set main setpoint of PZD field
@@ -295,6 +655,103 @@ class USS
      */
     void clearCtlFlag(const uint16_t flags, const int slaveIndex);
 
+    /**
+     * @brief Update control word and main setpoint of PZD field in one step
+     *
+     * @param setFlags Flags to set in the control word
+     * @param clearFlags Flags to clear from the control word, cleared before setFlags are set
+     * @param value Main setpoint as word (2 byte)
+     * @param slaveIndex Index of the slave the outputs should be set, index number acording to pslaves array
+     *                   from begin()
+     * @return none
+     *
+     * The bus sends either the old or the new values of both, never a mix of them.
+     */
+    void setOutputs(const uint16_t setFlags, const uint16_t clearFlags, const uint16_t value, const int slaveIndex);
+
+    /**
+     * @brief Set an additional setpoint of PZD field
+     *
+     * @param pzd Number of the PZD word, 3 to USS_PZD_WORDS, the meanings are specific to the concrete device
+     *            on the USS bus and therefore defined in a higher layer
+     * @param value Setpoint as word (2 byte)
+     * @param slaveIndex Index of the slave the setpoint should be set, index number acording to pslaves array
+     *                   from begin()
+     * @return none
+     */
+    void setAddSetpoint(const int pzd, const uint16_t value, const int slaveIndex);
+
+    /**
+     * @brief Send control word and main setpoint to all slaves at once with a broadcast telegram
+     *
+     * @param ctlword Control word for all slaves
+     * @param mainsetpoint Main setpoint for all slaves
+     * @retval 0: success
+     * @retval -1: begin() not called successfully or the telegram has additional PZD words (USS_PZD_WORDS > 2)
+     *
+     * The broadcast is sent instead of the next cyclic telegram, all slaves apply it at the same time and none
+     * of them answers. The process image of every slave is set to the same values, so the following cyclic
+     * telegrams don't change them back. A broadcast has one value for every word, it would overwrite the
+     * additional setpoints of every slave, so it is only sent with control word and main setpoint alone.
+     */
+    int broadcast(const uint16_t ctlword, const uint16_t mainsetpoint);
+
+    /**
+     * @brief Start a trajectory of control word flags and main setpoints for a slave, run by the bus cycle
+     *
+     * @param points Points of the trajectory sorted by time, copied, so the array can be reused at once
+     * @param nrPoints Number of points, 1 to USS_TRAJECTORY_LENGTH
+     * @param slaveIndex Index of the slave the trajectory is for, index number acording to pslaves array
+     *                   from begin()
+     * @param periodMs Time after which the trajectory starts again from its first point, must be after the
+     *                 last point, 0 to run it once
+     * @retval 0: success
+     * @retval -1: illegal parameters
+     *
+     * The trajectory starts now and replaces a running one of the slave. Every telegram to the slave takes over
+     * all points whose time is not after the deadline of its bus cycle, like setOutputs() called at that time.
+     * So the points are applied in the same cycles on every run, independent of the scheduling of application
+     * threads. Outputs set by the application in between are kept until the next point changes them. The bus
+     * thread never waits for them: when the trajectory is being changed or another thread writes the outputs
+     * of the slave right then, the due points are taken over by its next telegram.
+     */
+    int startTrajectory(const ussTrajectoryPoint_t points[], const int nrPoints, const int slaveIndex,
+                        const unsigned long periodMs = 0);
+
+    /**
+     * @brief Stop the trajectory of a slave, the outputs keep the values of the last point applied
+     *
+     * @param slaveIndex Index of the slave, index number acording to pslaves array from begin()
+     * @return none
+     */
+    void stopTrajectory(const int slaveIndex);
+
+    /**
+     * @brief Check if a trajectory is running for a slave
+     *
+     * @param slaveIndex Index of the slave, index number acording to pslaves array from begin()
+     * @return Boolean has the trajectory points that are not applied yet?
+     */
+    bool trajectoryRunning(const int slaveIndex) const;
+
+    /**
+     * @brief Watch the status word of a slave until flags have a value without blocking
+     *
+     * @param mask Flags of the status word to check
+     * @param value Value of the flags to wait for, like STATUS_WORD_OP_ENABLED_ENABLED
+     * @param slaveIndex Index of the slave, index number acording to pslaves array from begin()
+     * @param callback Function called when the status word matched or the deadline is over
+     * @param context User pointer passed to the callback
+     * @param timeoutMs Deadline of the watch in ms from now
+     * @retval 0: watch added
+     * @retval -1: illegal slave index, no callback or USS_STATUS_WATCHES watches of the slave are running
+     *
+     * The status word of every valid response of the slave is checked, the first one after this call that
+     * matches finishes the watch. So the callback is called by the bus cycle without any polling.
+     */
+    int waitStatusAsync(const uint16_t mask, const uint16_t value, const int slaveIndex, ussStatusCallback_t callback,
+                        void *context, const int timeoutMs);
+
     /**
      * @brief Get main actual value from specified USS slave
      *
@@ -304,6 +761,29 @@ class USS
      */
     uint16_t getActualvalue(const int slaveIndex) const;
 
+    /**
+     * @brief Get an additional actual value from specified USS slave
+     *
+     * @param pzd Number of the PZD word, 3 to USS_PZD_WORDS
+     * @param slaveIndex Index of the slave the actual value should be get from, index number acording to pslaves array
+     *                   from begin()
+     * @return Actual value as word (2 byte), 0xFFFF for illegal PZD number or slave index
+     */
+    uint16_t getAddActualvalue(const int pzd, const int slaveIndex) const;
+
+    /**
+     * @brief Get all PZD words of the last response of specified USS slave
+     *
+     * @param pzd Array of USS_PZD_WORDS words, gets status word, main actual value and the additional actual values
+     * @param slaveIndex Index of the slave the words should be get from, index number acording to pslaves array
+     *                   from begin()
+     * @retval 0: success
+     * @retval -1: illegal slave index
+     *
+     * All words are from the same response, so values like frequency and current always belong together.
+     */
+    int getInputs(uint16_t pzd[], const int slaveIndex) const;
+
     /**
      * @brief Check flag in status word from specified USS slave
      *
@@ -316,13 +796,17 @@ class USS
     bool checkStatusFlag(const uint16_t flag, const int slaveIndex) const;
 
     /**
-     * @brief Fill the send buffer and send over serial.
+     * @brief Update the telegram of the actual slave and send over serial.
      *
      * @return none
      *
-     * Fill the send buffer with control word, main setpoint, address of actual slave and parameter number and value,
-     * when configured for this slave via setParameter() functions, and send over serial. Generates BCC (Block Check
-     * Character), blocks until the cycle time is over from the last send. Must be called in loop() from application
+     * Every slave has a ready telegram with address, control word, main setpoint and parameter number and value,
+     * when configured for this slave via setParameter() functions. Only the words changed since its last telegram
+     * are written and the BCC (Block Check Character) is updated for them, then it is sent over serial.
+     * Sleeps until the absolute deadline of this cycle on CLOCK_MONOTONIC is reached. Every deadline advances by
+     * the gap of the slave polled before it, the spec cycle time calculated in begin() or, with setTiming(), the
+     * gap measured for that slave, so the bus doesn't drift and never waits busy. A pending broadcast() takes
+     * the place of the telegram. Must be called in loop() from application when startCyclic() is not used.
      */
     void send();
 
@@ -335,6 +819,8 @@ class USS
      * @retval -2: access denied
      * @retval -3: illegal parameter number
      *
+     * Waits with poll() on the serial device until the complete response telegram is received or the telegram
+     * runtime plus the maximum response delay of the slave is over, returns as soon as the telegram is complete.
      * Receives the response from USS salves checks the length and address and the BCC (Block Check character).
      * When all is correct, updates the status word and main actualvalue of the slave from which is the response.
      * When parameter was requested to set, error code from USS spec. is returned.
@@ -353,29 +839,297 @@ class USS
     } parameter_t;
 
     /**
-     * @brief Calculates the Block Check Character (BCC) like in USS spec.
+     * @brief Thread function of the bus master thread
+     *
+     * @param arg pointer to the USS instance
+     * @return nullptr
+     */
+    static void *cyclicThread(void *arg);
+
+    /**
+     * @brief Write a telegram to the serial device and switch the bus to receive
+     *
+     * @param telegram complete telegram of USS_BUFFER_LENGTH bytes
+     * @retval 0: success
+     * @retval -1: write to the serial device failed
+     */
+    int transmit(const byte telegram[]);
+
+    /**
+     * @struct process image outputs, struct of arrays so the words of all slaves are packed in few cache
+     *         lines, aligned to keep the lines written by application threads apart from the inputs
+     */
+    typedef struct alignas(64)
+    {
+        std::atomic<uint32_t> seq[USS_SLAVES];
+        std::atomic<uint16_t> ctlword[USS_SLAVES];
+        std::atomic<uint16_t> mainsetpoint[USS_SLAVES];
+        std::atomic<uint16_t> addsetpoint[USS_PZD_ADD_SLOTS][USS_SLAVES];
+    } outputImage_t;
+
+    /**
+     * @struct process image inputs, written by receive() only
+     */
+    typedef struct alignas(64)
+    {
+        std::atomic<uint32_t> seq[USS_SLAVES];
+        std::atomic<uint16_t> statusword[USS_SLAVES];
+        std::atomic<uint16_t> mainactualvalue[USS_SLAVES];
+        std::atomic<uint16_t> addactualvalue[USS_PZD_ADD_SLOTS][USS_SLAVES];
+    } inputImage_t;
+
+    /**
+     * @struct statistics published by the bus thread, copied word by word under a sequence counter like the
+     *         input image, the bus thread never waits for readers
+     */
+    typedef struct alignas(64)
+    {
+        std::atomic<uint32_t> seq;
+        std::atomic<uint64_t> words[(sizeof(ussSlaveStats_t) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+    } slaveStatsImage_t;
+
+    typedef struct alignas(64)
+    {
+        std::atomic<uint32_t> seq;
+        std::atomic<uint64_t> words[(sizeof(ussCycleStats_t) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+    } cycleStatsImage_t;
+
+    /**
+     * @struct adaptive timing of one slave, written by the bus thread only
+     */
+    typedef struct
+    {
+        long samples[USS_TIMING_SAMPLES];   // response latencies in us since the last update of the gap
+        int count;
+        int failures;                       // failed responses since the last update of the gap
+        long gap;                           // time from the telegram to the slave to the next telegram in us
+        unsigned long skip;                 // telegrams left out by the back-off before the slave is polled again
+    } timingSlave_t;
+
+    /**
+     * @struct parameter (PKW) job
+     */
+    typedef struct
+    {
+        uint16_t pke;                     // AK and parameter number
+        uint16_t ind;                     // parameter index
+        uint16_t pwe[2];                  // parameter value, high word first
+        int timeoutMs;
+        int retries;
+        int tries;                        // telegrams sent without valid response
+        int error;                        // result when the deadline or the retries are over, last failure
+        struct timespec deadline;         // on CLOCK_MONOTONIC
+        ussParamCallback_t callback;
+        void *context;
+    } ussParamJob_t;
+
+    /**
+     * @struct cached parameter value
+     */
+    typedef struct
+    {
+        uint16_t param;
+        uint16_t index;
+        uint32_t value;
+        struct timespec stamp;            // time the value was transferred on CLOCK_MONOTONIC
+        bool valid;
+    } paramCacheEntry_t;
+
+    /**
+     * @struct parameter jobs of one slave, queue is protected by m_pkwLock, active job only used by the bus,
+     *         cache is protected by m_cacheLock
+     */
+    typedef struct
+    {
+        ussParamJob_t queue[USS_PKW_QUEUE_LENGTH];
+        unsigned int head;
+        unsigned int count;
+        ussParamJob_t active;
+        std::atomic<bool> busy;           // active job waits for response
+        bool noTask;                      // no task is sent until the slave answers it, only used by the bus
+        uint16_t lastPke;                 // request of the job before, only used by the bus
+        uint16_t lastInd;
+        paramCacheEntry_t cache[USS_PARAM_CACHE_LENGTH];
+    } pkwSlave_t;
+
+    /**
+     * @struct setpoint trajectory of one slave, the flag is read by the bus thread every cycle, the points
+     *         only under the lock when it is set
+     */
+    typedef struct
+    {
+        ussTrajectoryPoint_t points[USS_TRAJECTORY_LENGTH];
+        int nrPoints;
+        int next;                         // first point not applied yet
+        unsigned long periodMs;
+        struct timespec start;            // time of the points on CLOCK_MONOTONIC, advanced by the period
+        std::atomic<bool> active;
+    } trajectory_t;
+
+    /**
+     * @struct status word watch
+     */
+    typedef struct
+    {
+        uint16_t mask;
+        uint16_t value;
+        struct timespec deadline;         // on CLOCK_MONOTONIC
+        ussStatusCallback_t callback;
+        void *context;
+    } statusWatch_t;
+
+    /**
+     * @struct completion of a blocking parameter job
+     */
+    typedef struct
+    {
+        std::atomic<bool> done;
+        int result;
+        uint32_t value;
+    } paramSync_t;
+
+    /**
+     * @brief Put a parameter job in the queue of a slave
+     *
+     * @return 0 on success, -1 on illegal slave index or full queue
+     */
+    int queueParamJob(ussParamJob_t &job, const int slaveIndex);
+
+    /**
+     * @brief Time out the active job of a slave and take the next job from its queue, called by send()
+     *
+     * Jobs whose deadline passed in the queue are finished with USS_PKW_ERR_TIMEOUT without being sent.
+     */
+    void nextParamJob(const int slaveIndex, const struct timespec &now);
+
+    /**
+     * @brief Apply the points of the trajectory of a slave due in a bus cycle, called by send()
+     *
+     * @param cycle deadline of the bus cycle on CLOCK_MONOTONIC
+     */
+    void runTrajectory(const int slaveIndex, const struct timespec &cycle);
+
+    /**
+     * @brief Finish the active job of a slave and call its callback
+     */
+    void finishParamJob(const int slaveIndex, const int result, const uint32_t value);
+
+    /**
+     * @brief Check that a PKW response answers a job and not the job before it
+     *
+     * @return true for an error response (AK 7, 8) or a value response (AK 1, 2) of the same parameter number
+     *         and index, for write jobs only with the written value
+     */
+    static bool paramResponseMatches(const ussParamJob_t &job, const uint16_t pke, const uint16_t ind,
+                                     const uint32_t pwe);
+
+    /**
+     * @brief Look up a parameter value in the cache of a slave
+     *
+     * @return true when a valid entry not older than maxAgeMs was found
+     */
+    bool readParamCache(const uint16_t param, const uint16_t index, const int slaveIndex, const int maxAgeMs,
+                        uint32_t &value) const;
+
+    /**
+     * @brief Store a parameter value in the cache of a slave, replaces the oldest entry when the cache is full
+     */
+    void writeParamCache(const uint16_t param, const uint16_t index, const int slaveIndex, const uint32_t value);
+
+    /**
+     * @brief Callback of blocking parameter jobs, marks the paramSync_t given as context done
+     */
+    static void paramSyncCallback(const int result, const uint16_t param, const uint32_t value, void *context);
+
+    /**
+     * @brief Wait until a blocking parameter job is finished
+     *
+     * @param sync completion of the job
+     * @return USS error code of the job
+     *
+     * Drives send() and receive() itself or sleeps until the bus master thread finished the job.
+     */
+    int waitParameter(paramSync_t &sync);
+
+    /**
+     * @brief Finish the status word watches of a slave that matched or whose deadline is over, called by the bus
+     *
+     * @param slaveIndex slave the telegram was sent to
+     * @param valid a valid response was received, so the status word is checked
+     * @param now time of the response on CLOCK_MONOTONIC
+     * @return none
+     */
+    void checkStatusWatches(const int slaveIndex, const bool valid, const struct timespec &now);
+
+    /**
+     * @brief Add the result of a telegram to the timing of the slave and update its gap, called by receive()
+     *
+     * @param slaveIndex slave the telegram was sent to
+     * @param valid a valid response was received
+     * @param latency latency of the response in us
+     * @return none
+     */
+    void updateTiming(const int slaveIndex, const bool valid, const long latency);
+
+    /**
+     * @brief Seqlock functions for the process image
      *
-     * @param buffer data over which the BCC is calculated
-     * @param length length in bytes over which the BCC is calculated
-     * @return the BCC value
+     * Outputs (control word, setpoints) are written by application threads and read by send(), inputs
+     * (status word, actual values) are written by receive() and read by application threads. Readers never
+     * block the writer, send() keeps the copy of the last cycle when the outputs are written concurrently.
      */
-    byte BCC(const char buffer[], const int length) const;
+    void lockOutput(const int slaveIndex);
+    bool tryLockOutput(const int slaveIndex);
+    void unlockOutput(const int slaveIndex);
+    bool readOutput(const int slaveIndex, uint32_t &seq, uint16_t &ctlword, uint16_t &mainsetpoint,
+                    uint16_t addsetpoint[]) const;
+    void writeInput(const int slaveIndex, const byte pzd[]);
+    void readInput(const int slaveIndex, uint16_t &statusword, uint16_t &mainactualvalue,
+                   uint16_t addactualvalue[] = nullptr) const;
+    static void publishStats(std::atomic<uint32_t> &seq, std::atomic<uint64_t> words[], const void *stats, const size_t size);
+    static void readStats(const std::atomic<uint32_t> &seq, const std::atomic<uint64_t> words[], void *stats, const size_t size);
 
-    char m_slaves[USS_SLAVES];
+    byte m_slaves[USS_SLAVES];
     int m_nrSlaves;
     int m_actualSlave;
-    char m_sendBuffer[USS_BUFFER_LENGTH];
-    char m_recvBuffer[USS_BUFFER_LENGTH];
-    uint16_t m_mainsetpoint[USS_SLAVES];
-    uint16_t m_mainactualvalue[USS_SLAVES];
-    uint16_t m_ctlword[USS_SLAVES];
-    uint16_t m_statusword[USS_SLAVES];
-    uint16_t m_paramValue[PKW_LENGTH_CHARACTERS / 2][USS_SLAVES];
-    unsigned long m_nextSend;             // timestamp of next send in ms, compare to millis()
-    unsigned long m_period;               // cycle time between sending frames in ms
+    byte m_sendBuffer[USS_BUFFER_LENGTH];           // broadcast telegram
+    byte m_recvBuffer[USS_MAX_TELEGRAM_LENGTH];     // last telegram from the parser
+    USSParser m_parser;                             // received bytes not parsed yet
+    outputImage_t m_out;                            // hot data of the slaves, touched every cycle
+    inputImage_t m_in;
+    byte m_txFrame[USS_SLAVES][USS_BUFFER_LENGTH];  // ready telegram of every slave, as sent in the last cycle
+    uint32_t m_txSeq[USS_SLAVES];                   // sequence number of the outputs in the frame
+    pkwSlave_t m_pkw[USS_SLAVES];                   // cold data, parameter jobs
+    mutable pthread_mutex_t m_pkwLock;
+    mutable pthread_mutex_t m_cacheLock;
+    trajectory_t m_trajectory[USS_SLAVES];
+    mutable pthread_mutex_t m_trajectoryLock;
+    statusWatch_t m_watches[USS_SLAVES][USS_STATUS_WATCHES];
+    std::atomic<int> m_nrWatches[USS_SLAVES];           // only read without the lock to skip slaves without watches
+    pthread_mutex_t m_watchLock;
+    struct timespec m_nextSend;           // absolute deadline of next send on CLOCK_MONOTONIC
+    struct timespec m_lastSend;           // actual time of last send on CLOCK_MONOTONIC
+    unsigned long m_period;               // spec cycle time between sending frames in us
     int m_characterRuntime;
-    int m_dePin;
-    time_t rs_begin, rs_end ;
+    USSTransport *m_transport;            // backend for the serial device
+    bool m_ownTransport;                  // transport created by begin() with driver enable pin, deleted with the instance
+    long long m_respTimeout;              // max time to wait for a complete response in ns
+    ussCycleStats_t m_cycleStats;         // written by the bus thread only, readers get the published copies
+    cycleStatsImage_t m_cycleStatsImage;
+    ussSlaveStats_t m_slaveStats[USS_SLAVES];
+    slaveStatsImage_t m_slaveStatsImage[USS_SLAVES];
+    ussTimingConfig_t m_timingConfig;
+    timingSlave_t m_timing[USS_SLAVES];
+    long m_telegramRuntime;               // runtime of a telegram with start pause in us, base of the adaptive gap
+    struct timespec m_txEnd;              // end of the last telegram, start of the response latency
+    bool m_txFailed;                      // last telegram couldn't be written, no response expected
+    std::atomic<bool> m_cyclicRun;
+    ussRtConfig_t m_rtConfig;             // execution mode of the bus master thread
+    struct timespec m_cycleStart;         // deadline of the running cycle
+    pthread_t m_cyclicThread;
+    std::atomic<uint64_t> m_broadcast;    // USS_BROADCAST_PENDING, control word and setpoint of next broadcast
+    bool m_broadcastSent;                 // last telegram was a broadcast, no response expected
+    USSTelemetry *m_recorder;             // telemetry log of the process data, nullptr when not recording
 };
 
 #endif
@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSBusManager.cpp
+ *   @brief  class implementation for running several independent USS buses
+ *   @date   17.10.2026
+ */
+#include "USSBusManager.h"
+
+USSBusManager::USSBusManager() :
+    m_buses{nullptr},
+    m_configs{},
+    m_nrBuses(0)
+{
+}
+
+USSBusManager::~USSBusManager()
+{
+    stopAll();
+}
+
+int USSBusManager::add(USS *bus, const int cpu)
+{
+    ussRtConfig_t config = {cpu, 0, false};
+
+    return add(bus, config);
+}
+
+int USSBusManager::add(USS *bus, const ussRtConfig_t &config)
+{
+    if(bus == nullptr || m_nrBuses == USS_BUS_MANAGER_BUSES)
+        return -1;
+
+    for(int i = 0; i < m_nrBuses; i++)
+    {
+        if(m_buses[i] == bus)
+            return -1;
+    }
+
+    m_buses[m_nrBuses] = bus;
+    m_configs[m_nrBuses] = config;
+
+    return m_nrBuses++;
+}
+
+int USSBusManager::startAll()
+{
+    bool started[USS_BUS_MANAGER_BUSES] = {};
+
+    for(int i = 0; i < m_nrBuses; i++)
+    {
+        if(m_buses[i]->cyclicRunning())
+            continue;
+
+        int ret = m_buses[i]->startCyclic(m_configs[i]);
+
+        if(ret != 0)
+        {
+            // only undo this call, buses running before belong to the caller
+            for(int j = 0; j < i; j++)
+            {
+                if(started[j])
+                    m_buses[j]->stopCyclic();
+            }
+
+            return ret;
+        }
+
+        started[i] = true;
+    }
+
+    return 0;
+}
+
+void USSBusManager::stopAll()
+{
+    for(int i = 0; i < m_nrBuses; i++)
+        m_buses[i]->stopCyclic();
+}
+
+int USSBusManager::nrBuses() const
+{
+    return m_nrBuses;
+}
+
+USS *USSBusManager::getBus(const int index) const
+{
+    if(index < 0 || index >= m_nrBuses)
+        return nullptr;
+
+    return m_buses[index];
+}
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSBusManager.h
+ *   @brief  class definition for running several independent USS buses, each with its
+ *           own bus master thread, optionally pinned to a CPU core.
+ *   @date   17.10.2026
+ */
+#ifndef USS_BUS_MANAGER_H
+#define USS_BUS_MANAGER_H
+
+#include "USS.h"
+
+/**
+ * @brief Max number of USS buses handled by one bus manager
+ */
+#define USS_BUS_MANAGER_BUSES      8
+
+class USSBusManager
+{
+    public:
+
+    /**
+     * @brief Constructor for USSBusManager class, initializes the members
+     *
+     * @return none
+     */
+    USSBusManager();
+
+    /**
+     * @brief Destructor for USSBusManager class, stops all bus master threads
+     */
+    ~USSBusManager();
+
+    /**
+     * @brief Add a bus to the manager, the bus must be configured with USS::begin() before
+     *
+     * @param bus USS instance of the bus, every instance owns its serial device
+     * @param cpu CPU core the bus master thread of this bus is pinned to, -1 to let the scheduler choose
+     * @return index of the bus in the manager, -1 when the manager is full or the bus was added before
+     */
+    int add(USS *bus, const int cpu = -1);
+
+    /**
+     * @brief Add a bus to the manager, its bus master thread runs in real-time mode
+     *
+     * @param bus USS instance of the bus, every instance owns its serial device
+     * @param config CPU core, priority and memory locking of the bus master thread, see USS::startCyclic()
+     * @return index of the bus in the manager, -1 when the manager is full or the bus was added before
+     */
+    int add(USS *bus, const ussRtConfig_t &config);
+
+    /**
+     * @brief Start the bus master threads of all buses
+     *
+     * @retval 0: success
+     * @retval -1: failure, threads started by this call are stopped again
+     * @retval -2: no permission for the real-time mode of a bus, threads started by this call are stopped again
+     *
+     * Buses whose thread was running before are skipped and keep running on a failure.
+     * Every bus runs its cyclic exchange in its own thread, so the buses don't wait for each other and drives
+     * can be split across buses to keep the cycle time when the number of drives grows.
+     */
+    int startAll();
+
+    /**
+     * @brief Stop the bus master threads of all buses
+     *
+     * @return none
+     */
+    void stopAll();
+
+    /**
+     * @brief Get number of buses in the manager
+     *
+     * @return number of buses
+     */
+    int nrBuses() const;
+
+    /**
+     * @brief Get a bus of the manager
+     *
+     * @param index index of the bus returned by add()
+     * @return USS instance of the bus, nullptr on illegal index
+     */
+    USS *getBus(const int index) const;
+
+    private:
+
+    USS *m_buses[USS_BUS_MANAGER_BUSES];
+    ussRtConfig_t m_configs[USS_BUS_MANAGER_BUSES];
+    int m_nrBuses;
+};
+
+#endif
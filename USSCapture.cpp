@@ -0,0 +1,286 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSCapture.cpp
+ *   @brief  class implementations for capturing the raw bytes on the bus into a binary file and reading it back
+ *   @date   17.10.2026
+ */
+#include "USSCapture.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+
+USSCaptureTransport::USSCaptureTransport(USSTransport *transport, const char *path) :
+    m_transport(transport),
+    m_path(path),
+    m_ring{0},
+    m_head(0),
+    m_tail(0),
+    m_dropped(0),
+    m_fd(-1),
+    m_run(false),
+    m_thread()
+{
+}
+
+USSCaptureTransport::~USSCaptureTransport()
+{
+    closeFile();
+}
+
+int USSCaptureTransport::open(const char *sertty, const unsigned int speed)
+{
+    ussCaptureHeader_t header = {USS_CAPTURE_MAGIC, USS_CAPTURE_VERSION, 0, speed, 0};
+
+    if(m_transport == nullptr || m_path == nullptr || m_fd >= 0)
+        return -1;
+
+    m_fd = ::open(m_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if(m_fd < 0)
+        return -1;
+
+    m_head.store(0);
+    m_tail.store(0);
+    m_dropped.store(0);
+
+    if(::write(m_fd, &header, sizeof(header)) != sizeof(header))
+    {
+        closeFile();
+        return -1;
+    }
+
+    m_run.store(true);
+
+    if(pthread_create(&m_thread, nullptr, writerThread, this) != 0)
+    {
+        m_run.store(false);
+        closeFile();
+        return -1;
+    }
+
+    if(m_transport->open(sertty, speed) != 0)
+    {
+        closeFile();
+        return -1;
+    }
+
+    return 0;
+}
+
+void USSCaptureTransport::close()
+{
+    m_transport->close();
+    closeFile();
+}
+
+int USSCaptureTransport::write(const byte buffer[], const int length)
+{
+    const int ret = m_transport->write(buffer, length);
+
+    record(ret == 0 ? USS_CAPTURE_TX : USS_CAPTURE_ERROR, buffer, length);
+
+    return ret;
+}
+
+int USSCaptureTransport::read(byte buffer[], const int length, const struct timespec &deadline)
+{
+    const int ret = m_transport->read(buffer, length, deadline);
+
+    if(ret > 0)
+        record(USS_CAPTURE_RX, buffer, ret);
+    else
+        record(ret == 0 ? USS_CAPTURE_TIMEOUT : USS_CAPTURE_ERROR, nullptr, 0);
+
+    return ret;
+}
+
+unsigned long USSCaptureTransport::dropped() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+void USSCaptureTransport::record(const uint8_t direction, const byte data[], const int length)
+{
+    ussCaptureRecord_t record;
+    struct timespec now;
+    uint64_t head;
+
+    if(m_fd < 0)
+        return;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    record.timeNs = (uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+    record.length = length;
+    record.direction = direction;
+    record.reserved = 0;
+    record.reserved2 = 0;
+
+    head = m_head.load(std::memory_order_relaxed);
+
+    // records are only added as a whole, so the file stays readable when the writer falls behind
+    if(USS_CAPTURE_RING_LENGTH - (head - m_tail.load(std::memory_order_acquire)) < sizeof(record) + length)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    put(head, &record, sizeof(record));
+
+    if(length > 0)
+        put(head + sizeof(record), data, length);
+
+    m_head.store(head + sizeof(record) + length, std::memory_order_release);
+}
+
+void USSCaptureTransport::put(const uint64_t pos, const void *data, const size_t length)
+{
+    const size_t offset = pos & (USS_CAPTURE_RING_LENGTH - 1);
+    const size_t first = length < USS_CAPTURE_RING_LENGTH - offset ? length : USS_CAPTURE_RING_LENGTH - offset;
+
+    memcpy(m_ring + offset, data, first);
+    memcpy(m_ring, static_cast<const byte *>(data) + first, length - first);
+}
+
+void *USSCaptureTransport::writerThread(void *arg)
+{
+    USSCaptureTransport *capture = static_cast<USSCaptureTransport *>(arg);
+    const struct timespec interval = {0, USS_CAPTURE_WRITE_MS * NSEC_PER_MSEC};
+
+    while(capture->m_run.load(std::memory_order_relaxed))
+    {
+        capture->drain();
+        nanosleep(&interval, nullptr);
+    }
+
+    return nullptr;
+}
+
+void USSCaptureTransport::drain()
+{
+    const uint64_t head = m_head.load(std::memory_order_acquire);
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t offset;
+    size_t length;
+    ssize_t n;
+
+    while(tail != head)
+    {
+        offset = tail & (USS_CAPTURE_RING_LENGTH - 1);
+        length = head - tail < USS_CAPTURE_RING_LENGTH - offset ? head - tail : USS_CAPTURE_RING_LENGTH - offset;
+        n = ::write(m_fd, m_ring + offset, length);
+
+        if(n < 0 && errno == EINTR)
+            continue;
+
+        // a file that can't be written anymore doesn't stop the bus, the bytes are lost then
+        tail += n > 0 ? n : length;
+
+        // the bytes are given back to the bus thread as soon as they are in the file
+        m_tail.store(tail, std::memory_order_release);
+    }
+}
+
+void USSCaptureTransport::closeFile()
+{
+    uint32_t dropped;
+
+    if(m_run.load())
+    {
+        m_run.store(false);
+        pthread_join(m_thread, nullptr);
+    }
+
+    if(m_fd < 0)
+        return;
+
+    drain();
+
+    dropped = m_dropped.load(std::memory_order_relaxed);
+    pwrite(m_fd, &dropped, sizeof(dropped), offsetof(ussCaptureHeader_t, dropped));
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+USSCaptureReader::USSCaptureReader() :
+    m_file(nullptr)
+{
+}
+
+USSCaptureReader::~USSCaptureReader()
+{
+    close();
+}
+
+int USSCaptureReader::open(const char *path, unsigned int &speed)
+{
+    ussCaptureHeader_t header;
+
+    if(m_file != nullptr)
+        return -1;
+
+    m_file = fopen(path, "rb");
+
+    if(m_file == nullptr)
+        return -1;
+
+    if(fread(&header, sizeof(header), 1, m_file) != 1 || header.magic != USS_CAPTURE_MAGIC ||
+       header.version != USS_CAPTURE_VERSION)
+    {
+        close();
+        return -1;
+    }
+
+    speed = header.speed;
+
+    return 0;
+}
+
+void USSCaptureReader::close()
+{
+    if(m_file != nullptr)
+        fclose(m_file);
+
+    m_file = nullptr;
+}
+
+int USSCaptureReader::next(ussCaptureRecord_t &record, byte data[], const int maxLength)
+{
+    size_t n;
+
+    if(m_file == nullptr)
+        return -1;
+
+    n = fread(&record, 1, sizeof(record), m_file);
+
+    if(n == 0 && feof(m_file))
+        return 0;
+
+    if(n != sizeof(record) || record.length > maxLength)
+        return -1;
+
+    if(record.length > 0 && fread(data, 1, record.length, m_file) != record.length)
+        return -1;
+
+    return 1;
+}
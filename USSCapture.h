@@ -0,0 +1,225 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSCapture.h
+ *   @brief  class definitions for capturing the raw bytes on the bus into a binary file and reading it back.
+ *           USSCaptureTransport is put between USS and the real transport and records every written telegram
+ *           and every chunk of received bytes with a timestamp and the direction. The bus thread only copies
+ *           the records into a lock-free ring, a writer thread moves them to the file. Capture/uss_replay feeds a
+ *           capture into the parser or into the emulator again.
+ *   @date   17.10.2026
+ */
+#ifndef USS_CAPTURE_H
+#define USS_CAPTURE_H
+
+#include "USSTransport.h"
+#include <stdio.h>
+
+/**
+ * @brief Identification and version of the capture file
+ */
+#define USS_CAPTURE_MAGIC          0x50414355      // "UCAP"
+#define USS_CAPTURE_VERSION        1
+
+/**
+ * @brief Size of the ring between bus thread and writer thread in bytes, power of 2
+ */
+#ifndef USS_CAPTURE_RING_LENGTH
+#define USS_CAPTURE_RING_LENGTH    65536
+#endif
+
+/**
+ * @brief Interval of the writer thread in ms, a crash loses at most the records of the last interval
+ */
+#define USS_CAPTURE_WRITE_MS       10
+
+static_assert((USS_CAPTURE_RING_LENGTH & (USS_CAPTURE_RING_LENGTH - 1)) == 0, "USS_CAPTURE_RING_LENGTH must be a power of 2");
+
+/**
+ * @brief Direction of a record
+ */
+#define USS_CAPTURE_TX             1               // telegram written to the bus
+#define USS_CAPTURE_RX             2               // bytes received, any chunk of a telegram
+#define USS_CAPTURE_TIMEOUT        3               // no bytes until the deadline of the read, no data
+#define USS_CAPTURE_ERROR          4               // write or read failed, data of the failed write
+
+/**
+ * @struct structure definition for the header of the capture file
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t speed;                 // baudrate of the bus
+    uint32_t dropped;               // records lost because the ring was full, written by close()
+} ussCaptureHeader_t;
+
+/**
+ * @struct structure definition for a record of the capture file, length bytes of data follow it
+ */
+typedef struct
+{
+    uint64_t timeNs;                // end of the write or read on CLOCK_MONOTONIC
+    uint16_t length;
+    uint8_t direction;              // USS_CAPTURE_TX, USS_CAPTURE_RX, USS_CAPTURE_TIMEOUT or USS_CAPTURE_ERROR
+    uint8_t reserved;
+    uint32_t reserved2;
+} ussCaptureRecord_t;
+
+static_assert(sizeof(ussCaptureHeader_t) == 16 && sizeof(ussCaptureRecord_t) == 16, "capture file layout changed");
+
+class USSCaptureTransport : public USSTransport
+{
+    public:
+
+    /**
+     * @brief Constructor for USSCaptureTransport class
+     *
+     * @param transport transport to the bus, opened, closed and deleted by the caller
+     * @param path path of the capture file, created by open(), an existing file is overwritten
+     */
+    USSCaptureTransport(USSTransport *transport, const char *path);
+
+    /**
+     * @brief Destructor for USSCaptureTransport class, closes the capture file
+     */
+    virtual ~USSCaptureTransport();
+
+    /**
+     * @brief Open the transport and create the capture file
+     *
+     * @retval 0: success
+     * @retval -1: failure of the transport or the capture file
+     */
+    virtual int open(const char *sertty, const unsigned int speed);
+
+    /**
+     * @brief Close the transport, stop the writer thread and write the rest of the capture to the file
+     */
+    virtual void close();
+
+    virtual int write(const byte buffer[], const int length);
+    virtual int read(byte buffer[], const int length, const struct timespec &deadline);
+
+    /**
+     * @brief Get number of records lost because the ring was full
+     *
+     * @return records dropped since open()
+     */
+    unsigned long dropped() const;
+
+    private:
+
+    /**
+     * @brief Add a record to the ring, called by the bus thread only
+     *
+     * Only copies into the ring and does one release store of the write position, a record that doesn't fit
+     * is dropped and counted instead of waiting for the writer.
+     */
+    void record(const uint8_t direction, const byte data[], const int length);
+
+    /**
+     * @brief Copy bytes into the ring at a write position, wraps at its end
+     */
+    void put(const uint64_t pos, const void *data, const size_t length);
+
+    /**
+     * @brief Thread function of the writer thread
+     *
+     * @param arg pointer to the USSCaptureTransport instance
+     * @return nullptr
+     */
+    static void *writerThread(void *arg);
+
+    /**
+     * @brief Write all bytes in the ring to the file
+     */
+    void drain();
+
+    /**
+     * @brief Stop the writer thread, write the rest of the ring and close the file
+     */
+    void closeFile();
+
+    USSTransport *m_transport;
+    const char *m_path;
+    byte m_ring[USS_CAPTURE_RING_LENGTH];
+    alignas(64) std::atomic<uint64_t> m_head;     // written by the bus thread
+    alignas(64) std::atomic<uint64_t> m_tail;     // written by the writer thread
+    std::atomic<uint64_t> m_dropped;
+    int m_fd;
+    std::atomic<bool> m_run;
+    pthread_t m_thread;
+};
+
+class USSCaptureReader
+{
+    public:
+
+    /**
+     * @brief Constructor for USSCaptureReader class
+     *
+     * @return none
+     */
+    USSCaptureReader();
+
+    /**
+     * @brief Destructor for USSCaptureReader class, closes the capture file
+     */
+    ~USSCaptureReader();
+
+    /**
+     * @brief Open a capture file and check its header
+     *
+     * @param path path of the capture file
+     * @param speed baudrate of the bus the capture was taken on
+     * @retval 0: success
+     * @retval -1: file can't be read or is no capture of this version
+     */
+    int open(const char *path, unsigned int &speed);
+
+    /**
+     * @brief Close the capture file
+     *
+     * @return none
+     */
+    void close();
+
+    /**
+     * @brief Read the next record
+     *
+     * @param record header of the record
+     * @param data buffer for the data of the record
+     * @param maxLength size of data, longer records are an error
+     * @retval 1: record read
+     * @retval 0: end of the capture
+     * @retval -1: capture is broken, like the end of a capture of a process that was killed
+     */
+    int next(ussCaptureRecord_t &record, byte data[], const int maxLength);
+
+    private:
+
+    FILE *m_file;
+};
+
+#endif
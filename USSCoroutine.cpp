@@ -0,0 +1,384 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSCoroutine.cpp
+ *   @brief  class implementations for running drive sequences as C++20 coroutines
+ *   @date   17.10.2026
+ */
+#include "USSCoroutine.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <chrono>
+#include <exception>
+
+std::coroutine_handle<> USSTask::promise_type::finalAwaiter::await_suspend(
+    std::coroutine_handle<promise_type> handle) noexcept
+{
+    promise_type &promise = handle.promise();
+    USSAsync *async = promise.async;
+    std::coroutine_handle<> continuation = promise.continuation;
+
+    // nobody waits for the result of a spawned sequence, it frees itself
+    if(async != nullptr)
+    {
+        handle.destroy();
+        async->m_tasks--;
+        return std::noop_coroutine();
+    }
+
+    if(continuation)
+        return continuation;
+
+    return std::noop_coroutine();
+}
+
+void USSTask::promise_type::unhandled_exception()
+{
+    // the library has no exceptions, a throwing sequence is a bug of the application
+    std::terminate();
+}
+
+USSTask::USSTask(USSTask &&other) noexcept :
+    m_handle(other.m_handle)
+{
+    other.m_handle = nullptr;
+}
+
+USSTask::~USSTask()
+{
+    if(m_handle)
+        m_handle.destroy();
+}
+
+std::coroutine_handle<> USSTask::await_suspend(std::coroutine_handle<> caller) noexcept
+{
+    m_handle.promise().continuation = caller;
+
+    return m_handle;
+}
+
+USSAsync::ParamAwaiter::ParamAwaiter(USSAsync *async, const int kind, const uint16_t param, const uint16_t index,
+                                     const uint32_t value, void *out, const int slaveIndex, const int timeoutMs,
+                                     const int retries) :
+    m_async(async),
+    m_kind(kind),
+    m_param(param),
+    m_index(index),
+    m_value(value),
+    m_out(out),
+    m_slaveIndex(slaveIndex),
+    m_timeoutMs(timeoutMs),
+    m_retries(retries),
+    m_result(USS_PKW_ERR_TIMEOUT),
+    m_node{nullptr, nullptr}
+{
+}
+
+bool USSAsync::ParamAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    USS *bus = m_async->m_bus;
+    int ret;
+
+    m_node.handle = handle;
+
+    // the callback only posts the node, the coroutine is resumed by run() on this thread after the return
+    switch(m_kind)
+    {
+        case SET_WORD:
+            ret = bus->setParameterAsync(m_param, (uint16_t)m_value, m_slaveIndex, paramCallback, this, m_timeoutMs,
+                                         m_retries);
+            break;
+
+        case SET_DWORD:
+        case SET_FLOAT:
+            ret = bus->setParameterAsync(m_param, m_value, m_slaveIndex, paramCallback, this, m_timeoutMs, m_retries);
+            break;
+
+        default:
+            ret = bus->getParameterAsync(m_param, m_slaveIndex, m_index, paramCallback, this, m_timeoutMs, m_retries);
+            break;
+    }
+
+    if(ret != 0)
+    {
+        m_result = USS_PKW_ERR_NOT_QUEUED;
+        return false;
+    }
+
+    return true;
+}
+
+int USSAsync::ParamAwaiter::await_resume()
+{
+    if(m_result != 0)
+        return m_result;
+
+    switch(m_kind)
+    {
+        case GET_WORD:
+            *(uint16_t *)m_out = m_value & 0xFFFF;
+            break;
+
+        case GET_DWORD:
+            *(uint32_t *)m_out = m_value;
+            break;
+
+        case GET_FLOAT:
+            memcpy(m_out, &m_value, sizeof(float));
+            break;
+
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+USSAsync::StatusAwaiter::StatusAwaiter(USSAsync *async, const uint16_t mask, const uint16_t value,
+                                       const int slaveIndex, const int timeoutMs) :
+    m_async(async),
+    m_mask(mask),
+    m_value(value),
+    m_slaveIndex(slaveIndex),
+    m_timeoutMs(timeoutMs),
+    m_result(-1),
+    m_node{nullptr, nullptr}
+{
+}
+
+bool USSAsync::StatusAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    m_node.handle = handle;
+
+    if(m_async->m_bus->waitStatusAsync(m_mask, m_value, m_slaveIndex, statusCallback, this, m_timeoutMs) != 0)
+    {
+        m_result = -1;
+        return false;
+    }
+
+    return true;
+}
+
+USSAsync::SleepAwaiter::SleepAwaiter(USSAsync *async, const unsigned long ms) :
+    m_async(async),
+    m_ms(ms),
+    m_timer{nullptr, {0, 0}, nullptr}
+{
+}
+
+void USSAsync::SleepAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    ussAsyncTimer_t **pos = &m_async->m_timers;
+
+    m_timer.handle = handle;
+    clock_gettime(CLOCK_MONOTONIC, &m_timer.due);
+    ussTimespecAddNs(m_timer.due, (long long)m_ms * NSEC_PER_MSEC);
+
+    // sorted by due time, equal times keep their order
+    while(*pos != nullptr && ussTimespecDiffNs((*pos)->due, m_timer.due) <= 0)
+        pos = &(*pos)->next;
+
+    m_timer.next = *pos;
+    *pos = &m_timer;
+}
+
+USSAsync::USSAsync(USS *bus) :
+    m_bus(bus),
+    m_ready(nullptr),
+    m_wakeup(0),
+    m_timers(nullptr),
+    m_tasks(0)
+{
+}
+
+int USSAsync::spawn(USSTask &&task)
+{
+    USSTask::promise_type *promise;
+
+    if(!task.m_handle)
+        return -1;
+
+    promise = &task.m_handle.promise();
+    promise->async = this;
+    promise->node.handle = task.m_handle;
+    task.m_handle = nullptr;
+    m_tasks++;
+
+    post(&promise->node);
+
+    return 0;
+}
+
+int USSAsync::run()
+{
+    ussAsyncNode_t *node;
+    ussAsyncNode_t *next;
+    ussAsyncNode_t *fifo;
+    ussAsyncTimer_t *timer;
+    struct timespec now;
+    long long wait;
+
+    while(m_tasks > 0)
+    {
+        if(!m_bus->cyclicRunning())
+            return -1;
+
+        // the stack is in reverse order of the posts, resume them in the order the bus finished them
+        node = m_ready.exchange(nullptr, std::memory_order_acquire);
+        fifo = nullptr;
+
+        while(node != nullptr)
+        {
+            next = node->next;
+            node->next = fifo;
+            fifo = node;
+            node = next;
+        }
+
+        while(fifo != nullptr)
+        {
+            // the node is part of the awaiter in the coroutine frame, it is gone after the resume
+            next = fifo->next;
+            fifo->handle.resume();
+            fifo = next;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        while(m_timers != nullptr && ussTimespecDiffNs(now, m_timers->due) >= 0)
+        {
+            timer = m_timers;
+            m_timers = timer->next;
+            timer->handle.resume();
+        }
+
+        if(m_tasks == 0 || m_ready.load(std::memory_order_relaxed) != nullptr)
+            continue;
+
+        wait = USS_ASYNC_BUS_CHECK_MS * 1000000LL;
+
+        if(m_timers != nullptr)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+
+            if(ussTimespecDiffNs(m_timers->due, now) < wait)
+                wait = ussTimespecDiffNs(m_timers->due, now);
+        }
+
+        // one wakeup is enough for a burst of posts, the nodes are all in the ready list already
+        if(wait > 0 && m_wakeup.try_acquire_for(std::chrono::nanoseconds(wait)))
+        {
+            while(m_wakeup.try_acquire())
+                ;
+        }
+    }
+
+    return 0;
+}
+
+USSAsync::ParamAwaiter USSAsync::setParameter(const uint16_t param, const uint16_t value, const int slaveIndex,
+                                              const int timeoutMs, const int retries)
+{
+    return ParamAwaiter(this, SET_WORD, param, 0, value, nullptr, slaveIndex, timeoutMs, retries);
+}
+
+USSAsync::ParamAwaiter USSAsync::setParameter(const uint16_t param, const uint32_t value, const int slaveIndex,
+                                              const int timeoutMs, const int retries)
+{
+    return ParamAwaiter(this, SET_DWORD, param, 0, value, nullptr, slaveIndex, timeoutMs, retries);
+}
+
+USSAsync::ParamAwaiter USSAsync::setParameter(const uint16_t param, const float value, const int slaveIndex,
+                                              const int timeoutMs, const int retries)
+{
+    uint32_t v;
+
+    memcpy(&v, &value, sizeof(v));
+
+    return ParamAwaiter(this, SET_FLOAT, param, 0, v, nullptr, slaveIndex, timeoutMs, retries);
+}
+
+USSAsync::ParamAwaiter USSAsync::getParameter(const uint16_t param, uint16_t &value, const int slaveIndex,
+                                              const uint16_t index, const int timeoutMs, const int retries)
+{
+    return ParamAwaiter(this, GET_WORD, param, index, 0, &value, slaveIndex, timeoutMs, retries);
+}
+
+USSAsync::ParamAwaiter USSAsync::getParameter(const uint16_t param, uint32_t &value, const int slaveIndex,
+                                              const uint16_t index, const int timeoutMs, const int retries)
+{
+    return ParamAwaiter(this, GET_DWORD, param, index, 0, &value, slaveIndex, timeoutMs, retries);
+}
+
+USSAsync::ParamAwaiter USSAsync::getParameter(const uint16_t param, float &value, const int slaveIndex,
+                                              const uint16_t index, const int timeoutMs, const int retries)
+{
+    return ParamAwaiter(this, GET_FLOAT, param, index, 0, &value, slaveIndex, timeoutMs, retries);
+}
+
+USSAsync::StatusAwaiter USSAsync::waitStatus(const uint16_t mask, const uint16_t value, const int slaveIndex,
+                                             const int timeoutMs)
+{
+    return StatusAwaiter(this, mask, value, slaveIndex, timeoutMs);
+}
+
+USSAsync::SleepAwaiter USSAsync::sleep(const unsigned long ms)
+{
+    return SleepAwaiter(this, ms);
+}
+
+void USSAsync::post(ussAsyncNode_t *node)
+{
+    ussAsyncNode_t *head = m_ready.load(std::memory_order_relaxed);
+
+    do
+    {
+        node->next = head;
+    } while(!m_ready.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+
+    m_wakeup.release();
+}
+
+void USSAsync::paramCallback(const int result, const uint16_t param, const uint32_t value, void *context)
+{
+    ParamAwaiter *awaiter = (ParamAwaiter *)context;
+
+    (void)param;
+
+    awaiter->m_result = result;
+    awaiter->m_value = value;
+    awaiter->m_async->post(&awaiter->m_node);
+}
+
+void USSAsync::statusCallback(const int result, const uint16_t statusword, void *context)
+{
+    StatusAwaiter *awaiter = (StatusAwaiter *)context;
+
+    (void)statusword;
+
+    awaiter->m_result = result;
+    awaiter->m_async->post(&awaiter->m_node);
+}
+
+#endif
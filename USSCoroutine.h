@@ -0,0 +1,308 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSCoroutine.h
+ *   @brief  class definitions for running drive sequences as C++20 coroutines. A sequence is a USSTask that
+ *           co_awaits parameter jobs, status word flags and delays of USSAsync instead of blocking. The bus
+ *           cycle finishes the jobs and watches and hands the waiting coroutines to USSAsync::run(), which
+ *           resumes them one after another, so any number of sequences run on one thread without polling.
+ *           Only available when the compiler supports coroutines (-std=c++20).
+ *   @date   17.10.2026
+ */
+#ifndef USS_COROUTINE_H
+#define USS_COROUTINE_H
+
+#include "USS.h"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <semaphore>
+
+/**
+ * @brief Max time run() sleeps without checking that the bus master thread still runs
+ */
+#define USS_ASYNC_BUS_CHECK_MS     100
+
+class USSAsync;
+
+/**
+ * @struct structure definition for an entry of the ready queue of USSAsync, part of every waiting coroutine
+ */
+typedef struct ussAsyncNode
+{
+    struct ussAsyncNode *next;
+    std::coroutine_handle<> handle;
+} ussAsyncNode_t;
+
+/**
+ * @struct structure definition for a running delay, sorted list of the thread in USSAsync::run()
+ */
+typedef struct ussAsyncTimer
+{
+    struct ussAsyncTimer *next;
+    struct timespec due;            // on CLOCK_MONOTONIC
+    std::coroutine_handle<> handle;
+} ussAsyncTimer_t;
+
+class USSTask
+{
+    public:
+
+    /**
+     * @brief Promise of the coroutine, the result is given with co_return
+     */
+    struct promise_type
+    {
+        int result = 0;
+        std::coroutine_handle<> continuation;     // coroutine that co_awaits this task
+        USSAsync *async = nullptr;                 // set for tasks started with USSAsync::spawn()
+        ussAsyncNode_t node = {nullptr, nullptr};
+
+        /**
+         * @brief Resumes the coroutine that co_awaits the task, or frees a task started with spawn()
+         */
+        struct finalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+            void await_resume() const noexcept {}
+        };
+
+        USSTask get_return_object() { return USSTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        finalAwaiter final_suspend() noexcept { return {}; }
+        void return_value(const int value) { result = value; }
+        void unhandled_exception();
+    };
+
+    USSTask(USSTask &&other) noexcept;
+    USSTask(const USSTask &) = delete;
+    USSTask &operator=(const USSTask &) = delete;
+
+    /**
+     * @brief Destructor for USSTask class, frees the coroutine unless it was given to USSAsync::spawn()
+     */
+    ~USSTask();
+
+    /**
+     * @brief A task co_awaited in another coroutine starts then and returns its co_return value to it
+     */
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept;
+    int await_resume() const noexcept { return m_handle.promise().result; }
+
+    private:
+
+    friend class USSAsync;
+
+    explicit USSTask(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+class USSAsync
+{
+    public:
+
+    /**
+     * @brief Awaitable parameter job, co_await gives the USS error code like USS::setParameter() or
+     *        USS_PKW_ERR_NOT_QUEUED when the job couldn't be queued
+     */
+    class ParamAwaiter
+    {
+        public:
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        int await_resume();
+
+        private:
+
+        friend class USSAsync;
+
+        ParamAwaiter(USSAsync *async, const int kind, const uint16_t param, const uint16_t index, const uint32_t value,
+                     void *out, const int slaveIndex, const int timeoutMs, const int retries);
+
+        USSAsync *m_async;
+        int m_kind;
+        uint16_t m_param;
+        uint16_t m_index;
+        uint32_t m_value;               // value to set, value of the response
+        void *m_out;                    // value of a get job is written to it
+        int m_slaveIndex;
+        int m_timeoutMs;
+        int m_retries;
+        int m_result;
+        ussAsyncNode_t m_node;
+    };
+
+    /**
+     * @brief Awaitable status word watch, co_await gives 0 when the flags matched or -1 on timeout
+     */
+    class StatusAwaiter
+    {
+        public:
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        int await_resume() const noexcept { return m_result; }
+
+        private:
+
+        friend class USSAsync;
+
+        StatusAwaiter(USSAsync *async, const uint16_t mask, const uint16_t value, const int slaveIndex,
+                      const int timeoutMs);
+
+        USSAsync *m_async;
+        uint16_t m_mask;
+        uint16_t m_value;
+        int m_slaveIndex;
+        int m_timeoutMs;
+        int m_result;
+        ussAsyncNode_t m_node;
+    };
+
+    /**
+     * @brief Awaitable delay
+     */
+    class SleepAwaiter
+    {
+        public:
+
+        bool await_ready() const noexcept { return m_ms == 0; }
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {}
+
+        private:
+
+        friend class USSAsync;
+
+        SleepAwaiter(USSAsync *async, const unsigned long ms);
+
+        USSAsync *m_async;
+        unsigned long m_ms;
+        ussAsyncTimer_t m_timer;
+    };
+
+    /**
+     * @brief Constructor for USSAsync class
+     *
+     * @param bus USS interface the jobs and watches of the coroutines are sent to, its bus master thread must run
+     */
+    USSAsync(USS *bus);
+
+    /**
+     * @brief Start a sequence, it runs in run()
+     *
+     * @param task coroutine of the sequence, it is freed when it is finished
+     * @retval 0: success
+     * @retval -1: task is empty
+     *
+     * Call it from the thread that calls run(), before it or from a running coroutine.
+     */
+    int spawn(USSTask &&task);
+
+    /**
+     * @brief Run the coroutines until all started sequences are finished
+     *
+     * @retval 0: all sequences finished
+     * @retval -1: the bus master thread is not running or was stopped, nothing would finish the jobs and watches
+     *
+     * Sleeps while all coroutines wait and resumes them when the bus cycle finished their job or watch or their
+     * delay is over. Call USS::startCyclic() before it. After -1 the unfinished sequences stay suspended, run()
+     * continues them when it is called again with the bus master thread running.
+     */
+    int run();
+
+    /**
+     * @brief Awaitable versions of USS::setParameter(), parameters like there
+     */
+    ParamAwaiter setParameter(const uint16_t param, const uint16_t value, const int slaveIndex,
+                              const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+    ParamAwaiter setParameter(const uint16_t param, const uint32_t value, const int slaveIndex,
+                              const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+    ParamAwaiter setParameter(const uint16_t param, const float value, const int slaveIndex,
+                              const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Awaitable versions of USS::getParameter(), parameters like there, always read from the slave
+     *
+     * value is written when the co_await returns 0, it must exist until then.
+     */
+    ParamAwaiter getParameter(const uint16_t param, uint16_t &value, const int slaveIndex, const uint16_t index = 0,
+                              const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+    ParamAwaiter getParameter(const uint16_t param, uint32_t &value, const int slaveIndex, const uint16_t index = 0,
+                              const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+    ParamAwaiter getParameter(const uint16_t param, float &value, const int slaveIndex, const uint16_t index = 0,
+                              const int timeoutMs = USS_PKW_TIMEOUT_MS, const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Wait until flags of the status word have a value, like USS::waitStatusAsync()
+     *
+     * @param mask Flags of the status word to check, like STATUS_WORD_SETPOINT_TOL_FLAG
+     * @param value Value of the flags to wait for, like STATUS_WORD_SETPOINT_TOL_IN_RANGE
+     * @param slaveIndex Index of the slave
+     * @param timeoutMs Max time to wait in ms
+     */
+    StatusAwaiter waitStatus(const uint16_t mask, const uint16_t value, const int slaveIndex, const int timeoutMs);
+
+    /**
+     * @brief Wait without blocking the thread, instead of sleep() in a sequence
+     *
+     * @param ms time to wait in ms, 0 doesn't suspend
+     */
+    SleepAwaiter sleep(const unsigned long ms);
+
+    private:
+
+    friend struct USSTask::promise_type::finalAwaiter;
+
+    enum
+    {
+        SET_WORD,
+        SET_DWORD,
+        SET_FLOAT,
+        GET_WORD,
+        GET_DWORD,
+        GET_FLOAT
+    };
+
+    /**
+     * @brief Add a coroutine to the ready queue, called by the bus thread, lock-free
+     */
+    void post(ussAsyncNode_t *node);
+
+    static void paramCallback(const int result, const uint16_t param, const uint32_t value, void *context);
+    static void statusCallback(const int result, const uint16_t statusword, void *context);
+
+    USS *m_bus;
+    std::atomic<ussAsyncNode_t *> m_ready;            // pushed by the bus thread, taken by run()
+    std::counting_semaphore<> m_wakeup;
+    ussAsyncTimer_t *m_timers;                        // only used by the thread in run()
+    int m_tasks;                                      // started and not finished
+};
+
+#endif
+
+#endif
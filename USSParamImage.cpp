@@ -0,0 +1,374 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSParamImage.cpp
+ *   @brief  class implementation for a memory mapped parameter image of a slave
+ *   @date   17.10.2026
+ */
+#include "USSParamImage.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+USSParamImage::USSParamImage() :
+    m_fd(-1),
+    m_header(nullptr),
+    m_entries(nullptr),
+    m_size(0)
+{
+}
+
+USSParamImage::~USSParamImage()
+{
+    close();
+}
+
+int USSParamImage::create(const char *path, const unsigned int capacity)
+{
+    void *map;
+
+    if(capacity == 0 || m_header != nullptr)
+        return -1;
+
+    m_size = sizeof(ussParamImageHeader_t) + (size_t)capacity * sizeof(ussParamImageEntry_t);
+
+    if(path == nullptr)
+    {
+        map = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    else
+    {
+        m_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+        if(m_fd < 0)
+            return -1;
+
+        if(ftruncate(m_fd, m_size) != 0)
+        {
+            close();
+            return -1;
+        }
+
+        map = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    }
+
+    if(map == MAP_FAILED)
+    {
+        close();
+        return -1;
+    }
+
+    m_header = static_cast<ussParamImageHeader_t *>(map);
+    m_entries = reinterpret_cast<ussParamImageEntry_t *>(m_header + 1);
+    m_header->magic = USS_PARAM_IMAGE_MAGIC;
+    m_header->version = USS_PARAM_IMAGE_VERSION;
+    m_header->recordSize = sizeof(ussParamImageEntry_t);
+    m_header->capacity = capacity;
+    m_header->count = 0;
+
+    return 0;
+}
+
+int USSParamImage::open(const char *path, const bool writable)
+{
+    struct stat st;
+    void *map;
+
+    if(path == nullptr || m_header != nullptr)
+        return -1;
+
+    m_fd = ::open(path, writable ? O_RDWR : O_RDONLY);
+
+    if(m_fd < 0)
+        return -1;
+
+    if(fstat(m_fd, &st) != 0 || (size_t)st.st_size < sizeof(ussParamImageHeader_t))
+    {
+        close();
+        return -1;
+    }
+
+    // a private mapping of a read only file can still be changed, the changes are just not written back
+    m_size = st.st_size;
+    map = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, writable ? MAP_SHARED : MAP_PRIVATE, m_fd, 0);
+
+    if(map == MAP_FAILED)
+    {
+        close();
+        return -1;
+    }
+
+    m_header = static_cast<ussParamImageHeader_t *>(map);
+    m_entries = reinterpret_cast<ussParamImageEntry_t *>(m_header + 1);
+
+    if(m_header->magic != USS_PARAM_IMAGE_MAGIC || m_header->version != USS_PARAM_IMAGE_VERSION ||
+       m_header->recordSize != sizeof(ussParamImageEntry_t) || m_header->count > m_header->capacity ||
+       sizeof(ussParamImageHeader_t) + (size_t)m_header->capacity * sizeof(ussParamImageEntry_t) > m_size)
+    {
+        close();
+        return -1;
+    }
+
+    return 0;
+}
+
+void USSParamImage::close()
+{
+    if(m_header != nullptr)
+    {
+        if(m_fd >= 0)
+            msync(m_header, m_size, MS_SYNC);
+
+        munmap(m_header, m_size);
+    }
+
+    if(m_fd >= 0)
+        ::close(m_fd);
+
+    m_header = nullptr;
+    m_entries = nullptr;
+    m_fd = -1;
+    m_size = 0;
+}
+
+int USSParamImage::add(const uint16_t param, const uint16_t index, const uint8_t type, const uint32_t value)
+{
+    ussParamImageEntry_t *e;
+
+    if(m_header == nullptr || m_header->count == m_header->capacity || type < USS_PARAM_TYPE_WORD ||
+       type > USS_PARAM_TYPE_FLOAT)
+        return -1;
+
+    e = &m_entries[m_header->count];
+    e->param = param;
+    e->index = index;
+    e->type = type;
+    e->result = 0;
+    e->reserved = 0;
+    e->value = type == USS_PARAM_TYPE_WORD ? value & 0xFFFF : value;
+    m_header->count++;
+
+    return 0;
+}
+
+int USSParamImage::addRange(const uint16_t firstParam, const uint16_t lastParam, const uint16_t nrIndices,
+                            const uint8_t type)
+{
+    const unsigned long n = ((unsigned long)lastParam - firstParam + 1) * nrIndices;
+
+    if(m_header == nullptr || lastParam < firstParam || nrIndices == 0 || type < USS_PARAM_TYPE_WORD ||
+       type > USS_PARAM_TYPE_FLOAT || n > m_header->capacity - m_header->count)
+        return -1;
+
+    for(unsigned long param = firstParam; param <= lastParam; param++)
+    {
+        for(uint16_t index = 0; index < nrIndices; index++)
+            add(param, index, type);
+    }
+
+    return 0;
+}
+
+int USSParamImage::removeMissing()
+{
+    unsigned int n = 0;
+    int removed;
+
+    if(m_header == nullptr)
+        return 0;
+
+    for(unsigned int i = 0; i < m_header->count; i++)
+    {
+        if(m_entries[i].result != USS_PKW_ERR_ILLEGAL_PARAM)
+            m_entries[n++] = m_entries[i];
+    }
+
+    removed = m_header->count - n;
+    m_header->count = n;
+
+    return removed;
+}
+
+unsigned int USSParamImage::count() const
+{
+    return m_header != nullptr ? m_header->count : 0;
+}
+
+const ussParamImageEntry_t *USSParamImage::entry(const unsigned int i) const
+{
+    if(m_header == nullptr || i >= m_header->count)
+        return nullptr;
+
+    return &m_entries[i];
+}
+
+int USSParamImage::readDrive(USS *bus, const int slaveIndex, const int timeoutMs, const int retries)
+{
+    paramImageJob_t *jobs;
+    int failed;
+
+    if(m_header == nullptr || bus == nullptr || bus->pendingParameters(slaveIndex) < 0)
+        return -1;
+
+    if(m_header->count == 0)
+        return 0;
+
+    jobs = static_cast<paramImageJob_t *>(malloc(m_header->count * sizeof(paramImageJob_t)));
+
+    if(jobs == nullptr)
+        return -1;
+
+    failed = transfer(bus, slaveIndex, false, nullptr, jobs, timeoutMs, retries);
+
+    for(unsigned int i = 0; i < m_header->count; i++)
+    {
+        if(jobs[i].result == 0)
+            m_entries[i].value = m_entries[i].type == USS_PARAM_TYPE_WORD ? jobs[i].value & 0xFFFF : jobs[i].value;
+    }
+
+    free(jobs);
+
+    return failed;
+}
+
+int USSParamImage::writeDrive(USS *bus, const int slaveIndex, unsigned int &written, const int timeoutMs,
+                              const int retries)
+{
+    paramImageJob_t *jobs;
+    bool *selected;
+    uint32_t actual;
+    int failed;
+
+    written = 0;
+
+    if(m_header == nullptr || bus == nullptr || bus->pendingParameters(slaveIndex) < 0)
+        return -1;
+
+    if(m_header->count == 0)
+        return 0;
+
+    jobs = static_cast<paramImageJob_t *>(malloc(m_header->count * sizeof(paramImageJob_t)));
+    selected = static_cast<bool *>(malloc(m_header->count * sizeof(bool)));
+
+    if(jobs == nullptr || selected == nullptr)
+    {
+        free(jobs);
+        free(selected);
+        return -1;
+    }
+
+    // reads are as cheap as writes on the bus, but writes can make the slave store to its EEPROM
+    failed = transfer(bus, slaveIndex, false, nullptr, jobs, timeoutMs, retries);
+
+    for(unsigned int i = 0; i < m_header->count; i++)
+    {
+        actual = m_entries[i].type == USS_PARAM_TYPE_WORD ? jobs[i].value & 0xFFFF : jobs[i].value;
+        selected[i] = jobs[i].result == 0 && actual != m_entries[i].value;
+
+        if(selected[i])
+            written++;
+    }
+
+    if(written > 0)
+        failed += transfer(bus, slaveIndex, true, selected, jobs, timeoutMs, retries);
+
+    free(jobs);
+    free(selected);
+
+    return failed;
+}
+
+int USSParamImage::transfer(USS *bus, const int slaveIndex, const bool set, const bool selected[],
+                            paramImageJob_t jobs[], const int timeoutMs, const int retries)
+{
+    const unsigned int count = m_header->count;
+    unsigned int next = 0;
+    int failed = 0;
+    int budgetMs;
+    int ret;
+
+    while(next < count)
+    {
+        // the queue of the slave is filled, so the bus sends the next job with the telegram after a response
+        while(next < count)
+        {
+            const ussParamImageEntry_t &e = m_entries[next];
+
+            if(selected != nullptr && !selected[next])
+            {
+                next++;
+                continue;
+            }
+
+            jobs[next].result = USS_PKW_ERR_TIMEOUT;
+            jobs[next].value = 0;
+
+            // the deadline runs from queuing, so the jobs in the queue before this one are added to its time
+            budgetMs = timeoutMs * (bus->pendingParameters(slaveIndex) + 1);
+
+            if(!set)
+                ret = bus->getParameterAsync(e.param, slaveIndex, e.index, jobCallback, &jobs[next], budgetMs,
+                                             retries);
+            else if(e.type == USS_PARAM_TYPE_WORD)
+                ret = bus->setParameterIndexAsync(e.param, e.index, (uint16_t)e.value, slaveIndex, jobCallback,
+                                                  &jobs[next], budgetMs, retries);
+            else
+                ret = bus->setParameterIndexAsync(e.param, e.index, e.value, slaveIndex, jobCallback, &jobs[next],
+                                                  budgetMs, retries);
+
+            // a full queue is retried after the flush, anything else can't be sent at all
+            if(ret != 0 && bus->pendingParameters(slaveIndex) >= USS_PKW_QUEUE_LENGTH)
+                break;
+
+            if(ret != 0)
+                jobs[next].result = -1;
+
+            next++;
+        }
+
+        bus->flushParameters();
+    }
+
+    for(unsigned int i = 0; i < count; i++)
+    {
+        if(selected != nullptr && !selected[i])
+            continue;
+
+        m_entries[i].result = jobs[i].result;
+
+        if(jobs[i].result != 0)
+            failed++;
+    }
+
+    return failed;
+}
+
+void USSParamImage::jobCallback(const int result, const uint16_t param, const uint32_t value, void *context)
+{
+    paramImageJob_t *job = static_cast<paramImageJob_t *>(context);
+
+    (void)param;
+
+    job->result = result;
+    job->value = value;
+}
@@ -0,0 +1,241 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSParamImage.h
+ *   @brief  class definition for a parameter image, a memory mapped binary file of parameter number, index, type
+ *           and value of a list of parameters. readDrive() fills it from a slave, writeDrive() restores it to a
+ *           slave and only writes the values the slave doesn't have already. The jobs of both are queued for
+ *           the whole queue of the slave at once, so the bus sends one job per telegram without waiting for
+ *           the application in between.
+ *   @date   17.10.2026
+ */
+#ifndef USS_PARAM_IMAGE_H
+#define USS_PARAM_IMAGE_H
+
+#include "USS.h"
+
+/**
+ * @brief Identification and version of the image file
+ */
+#define USS_PARAM_IMAGE_MAGIC      0x4D495055      // "UPIM"
+#define USS_PARAM_IMAGE_VERSION    1
+
+/**
+ * @brief Type of the value of a parameter
+ */
+#define USS_PARAM_TYPE_WORD        1               // 2 byte, compared in the low word of value only
+#define USS_PARAM_TYPE_DWORD       2               // 4 byte
+#define USS_PARAM_TYPE_FLOAT       3               // single precision, compared bit by bit
+
+/**
+ * @struct structure definition for one parameter of the image, also the record in the image file
+ */
+typedef struct
+{
+    uint16_t param;
+    uint16_t index;
+    uint8_t type;                   // USS_PARAM_TYPE_WORD, USS_PARAM_TYPE_DWORD or USS_PARAM_TYPE_FLOAT
+    uint8_t reserved;
+    int16_t result;                 // USS error code of the last transfer with a slave, 0 before the first,
+                                    // error numbers of the slave go up to 255
+    uint32_t value;                 // float values as their bits
+} ussParamImageEntry_t;
+
+static_assert(sizeof(ussParamImageEntry_t) == 12, "record of the image file must be 12 bytes");
+
+/**
+ * @struct structure definition for the header of the image file, the records follow it
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t capacity;              // number of records in the file
+    uint32_t count;                 // records in use
+} ussParamImageHeader_t;
+
+static_assert(sizeof(ussParamImageHeader_t) == 16, "header of the image file must be 16 bytes");
+
+class USSParamImage
+{
+    public:
+
+    /**
+     * @brief Constructor for USSParamImage class, initializes the members
+     *
+     * @return none
+     */
+    USSParamImage();
+
+    /**
+     * @brief Destructor for USSParamImage class, closes the image
+     */
+    ~USSParamImage();
+
+    /**
+     * @brief Create an empty image
+     *
+     * @param path path of the image file, an existing file is overwritten, nullptr for an image in memory only
+     * @param capacity max number of parameters
+     * @retval 0: success
+     * @retval -1: image is open already, illegal capacity or the file can't be created
+     */
+    int create(const char *path, const unsigned int capacity);
+
+    /**
+     * @brief Open an existing image file
+     *
+     * @param path path of the image file
+     * @param writable true to write changed values and results back to the file, otherwise they only change the
+     *                 mapping and the file stays as it is
+     * @retval 0: success
+     * @retval -1: image is open already, the file can't be mapped or is no image of this version
+     */
+    int open(const char *path, const bool writable = false);
+
+    /**
+     * @brief Close the image, a writable file is written to the disk
+     *
+     * @return none
+     */
+    void close();
+
+    /**
+     * @brief Add a parameter to the image
+     *
+     * @param param Parameter number
+     * @param index Parameter index for indexed parameters
+     * @param type USS_PARAM_TYPE_WORD, USS_PARAM_TYPE_DWORD or USS_PARAM_TYPE_FLOAT
+     * @param value Value to restore, readDrive() overwrites it
+     * @retval 0: success
+     * @retval -1: image not open, full or illegal type
+     */
+    int add(const uint16_t param, const uint16_t index, const uint8_t type, const uint32_t value = 0);
+
+    /**
+     * @brief Add a range of parameters with the same type to the image
+     *
+     * @param firstParam First parameter number
+     * @param lastParam Last parameter number, included
+     * @param nrIndices Number of indices of every parameter, 1 for not indexed parameters
+     * @param type USS_PARAM_TYPE_WORD, USS_PARAM_TYPE_DWORD or USS_PARAM_TYPE_FLOAT
+     * @retval 0: success
+     * @retval -1: image not open, too small for the range or illegal arguments, nothing is added then
+     *
+     * Numbers the slave doesn't have are reported by readDrive() and can be dropped with removeMissing().
+     */
+    int addRange(const uint16_t firstParam, const uint16_t lastParam, const uint16_t nrIndices, const uint8_t type);
+
+    /**
+     * @brief Remove the parameters the slave reported as illegal on the last transfer
+     *
+     * @return number of removed parameters
+     */
+    int removeMissing();
+
+    /**
+     * @brief Get number of parameters in the image
+     *
+     * @return number of parameters, 0 when the image is not open
+     */
+    unsigned int count() const;
+
+    /**
+     * @brief Get a parameter of the image
+     *
+     * @param i Number of the parameter in the image
+     * @return the parameter, nullptr for an illegal number
+     */
+    const ussParamImageEntry_t *entry(const unsigned int i) const;
+
+    /**
+     * @brief Read the values of all parameters of the image from a slave
+     *
+     * @param bus USS interface of the slave
+     * @param slaveIndex Index of the slave, index number acording to pslaves array from begin()
+     * @param timeoutMs Time in ms every parameter may take, a job queued behind others gets their time in addition
+     * @param retries Number of telegrams without valid response before a job fails
+     * @retval 0: all values read
+     * @retval -1: image not open or illegal arguments
+     * @retval >0: number of parameters that failed, their result shows the USS error code
+     *
+     * Blocks until all jobs are finished, runs the bus itself when the bus master thread is not running.
+     * Values of failed parameters are left as they are.
+     */
+    int readDrive(USS *bus, const int slaveIndex, const int timeoutMs = USS_PKW_TIMEOUT_MS,
+                  const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    /**
+     * @brief Restore the values of the image to a slave
+     *
+     * @param bus USS interface of the slave
+     * @param slaveIndex Index of the slave, index number acording to pslaves array from begin()
+     * @param written Number of parameters that had to be written
+     * @param timeoutMs Time in ms every parameter may take, a job queued behind others gets their time in addition
+     * @param retries Number of telegrams without valid response before a job fails
+     * @return like readDrive()
+     *
+     * Reads all parameters first and only writes the ones with a different value, so restoring a slave that
+     * has most values already costs one read per parameter. Parameters that can't be read are not written.
+     * The parameters are written in the order of the image, so parameters that depend on others must come
+     * after them, and the access level of the slave must allow to read all of them (G110::begin() sets expert).
+     * Parameters that can only be changed in a state of the slave fail with AK 7 and the error number of the
+     * slave as result otherwise, the caller must set that state before and reset it after, e.g. the motor data
+     * P0304 to P0311 of a G110 need quick commissioning (P0010 = 1) like in G110::begin().
+     */
+    int writeDrive(USS *bus, const int slaveIndex, unsigned int &written, const int timeoutMs = USS_PKW_TIMEOUT_MS,
+                   const int retries = USS_PKW_RETRIES_UNLIMITED);
+
+    private:
+
+    /**
+     * @struct structure definition for the result of one job
+     */
+    typedef struct
+    {
+        int result;
+        uint32_t value;
+    } paramImageJob_t;
+
+    /**
+     * @brief Run a job for every selected parameter and store the results in the image
+     *
+     * @param set true to write the values of the image, false to read the values into jobs
+     * @param selected parameters to transfer, all when nullptr
+     * @return number of failed jobs
+     */
+    int transfer(USS *bus, const int slaveIndex, const bool set, const bool selected[], paramImageJob_t jobs[],
+                 const int timeoutMs, const int retries);
+
+    /**
+     * @brief Callback of the jobs, stores result and value
+     */
+    static void jobCallback(const int result, const uint16_t param, const uint32_t value, void *context);
+
+    int m_fd;
+    ussParamImageHeader_t *m_header;
+    ussParamImageEntry_t *m_entries;
+    size_t m_size;                        // size of the mapping
+};
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSParser.cpp
+ *   @brief  class implementation for an incremental parser of USS telegrams
+ *   @date   17.10.2026
+ */
+#include "USSParser.h"
+
+#define USS_PARSER_MASK            (USS_PARSER_BUFFER_LENGTH - 1)
+
+USSParser::USSParser() :
+    m_buffer{0},
+    m_head(0),
+    m_tail(0),
+    m_stats()
+{
+}
+
+void USSParser::reset()
+{
+    m_head = 0;
+    m_tail = 0;
+}
+
+byte *USSParser::writeSpace(int &length)
+{
+    const unsigned int pos = m_tail & USS_PARSER_MASK;
+    const unsigned int free = USS_PARSER_BUFFER_LENGTH - (m_tail - m_head);
+
+    length = free < USS_PARSER_BUFFER_LENGTH - pos ? free : USS_PARSER_BUFFER_LENGTH - pos;
+
+    return m_buffer + pos;
+}
+
+void USSParser::commit(const int length)
+{
+    m_tail += length;
+}
+
+int USSParser::available() const
+{
+    return m_tail - m_head;
+}
+
+byte USSParser::at(const unsigned int offset) const
+{
+    return m_buffer[(m_head + offset) & USS_PARSER_MASK];
+}
+
+int USSParser::next(byte frame[], const int maxLength, const bool flush)
+{
+    while(true)
+    {
+        unsigned int n = m_tail - m_head;
+        unsigned int length;
+        byte bcc = 0;
+
+        while(n > 0 && at(0) != STX_BYTE_STX)
+        {
+            m_head++;
+            n--;
+            m_stats.skippedBytes++;
+        }
+
+        if(n == 0 || (n == 1 && !flush))
+            return 0;
+
+        if(n == 1)
+        {
+            m_head++;
+            m_stats.truncated++;
+            return 0;
+        }
+
+        length = at(1) + 2;
+
+        if(length < USS_PARSER_MIN_LGE + 2 || length > (unsigned int)maxLength)
+        {
+            m_head++;
+            m_stats.lgeErrors++;
+            continue;
+        }
+
+        if(n < length)
+        {
+            if(!flush)
+                return 0;
+
+            m_head++;
+            m_stats.truncated++;
+            continue;
+        }
+
+        for(unsigned int i = 0; i < length - 1; i++)
+            bcc ^= at(i);
+
+        if(bcc != at(length - 1))
+        {
+            m_head++;
+            m_stats.bccErrors++;
+            continue;
+        }
+
+        for(unsigned int i = 0; i < length; i++)
+            frame[i] = at(i);
+
+        m_head += length;
+        m_stats.frames++;
+
+        return length;
+    }
+}
+
+void USSParser::getStats(ussParserStats_t &stats) const
+{
+    stats = m_stats;
+}
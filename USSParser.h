@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSParser.h
+ *   @brief  class definition for an incremental parser of USS telegrams. Received bytes are written to a ring
+ *           buffer in any chunks, the parser searches the STX, checks LGE and BCC and returns complete
+ *           telegrams of any length. After noise or a lost character it resynchronizes on the next STX.
+ *   @date   17.10.2026
+ */
+#ifndef USS_PARSER_H
+#define USS_PARSER_H
+
+#include "USSProtocol.h"
+
+/**
+ * @brief Size of the ring buffer, power of 2 and large enough for two telegrams of max length
+ */
+#define USS_PARSER_BUFFER_LENGTH   512
+
+/**
+ * @brief Min value of LGE, telegram with ADR and BCC only
+ */
+#define USS_PARSER_MIN_LGE         2
+
+static_assert((USS_PARSER_BUFFER_LENGTH & (USS_PARSER_BUFFER_LENGTH - 1)) == 0, "USS_PARSER_BUFFER_LENGTH must be a power of 2");
+static_assert(USS_PARSER_BUFFER_LENGTH >= 2 * USS_MAX_TELEGRAM_LENGTH, "USS_PARSER_BUFFER_LENGTH too small");
+
+/**
+ * @struct structure definition for the counters of the parser
+ */
+typedef struct
+{
+    unsigned long frames;           // complete telegrams with correct BCC
+    unsigned long skippedBytes;     // bytes before an STX
+    unsigned long lgeErrors;        // STX followed by an illegal length
+    unsigned long bccErrors;
+    unsigned long truncated;        // incomplete telegrams dropped by flush
+} ussParserStats_t;
+
+class USSParser
+{
+    public:
+
+    /**
+     * @brief Constructor for USSParser class, initializes an empty buffer
+     *
+     * @return none
+     */
+    USSParser();
+
+    /**
+     * @brief Drop all bytes in the buffer
+     *
+     * @return none
+     */
+    void reset();
+
+    /**
+     * @brief Get free space in the ring buffer to receive into, without copying
+     *
+     * @param length number of free bytes at the returned position, 0 when the buffer is full
+     * @return position to write the received bytes to
+     *
+     * Only the contiguous space up to the end of the ring is returned, the rest is returned by the next call.
+     * The buffer can only run full when next() isn't called.
+     */
+    byte *writeSpace(int &length);
+
+    /**
+     * @brief Add received bytes written to the space returned by writeSpace() to the buffer
+     *
+     * @param length number of bytes received
+     * @return none
+     */
+    void commit(const int length);
+
+    /**
+     * @brief Get the next complete telegram from the buffer
+     *
+     * @param frame buffer the telegram is copied to, starting with STX
+     * @param maxLength size of frame, longer telegrams are treated as illegal length
+     * @param flush no more bytes will come, so an incomplete telegram at the start is dropped and the buffer is
+     *              searched for a telegram after it
+     * @return length of the telegram, 0 when there is no complete telegram
+     *
+     * Bytes before an STX are skipped. When LGE is illegal or the BCC is wrong only the STX is dropped, so a
+     * telegram starting inside the rejected bytes is still found.
+     */
+    int next(byte frame[], const int maxLength, const bool flush = false);
+
+    /**
+     * @brief Get number of bytes in the buffer
+     *
+     * @return bytes in the buffer
+     */
+    int available() const;
+
+    /**
+     * @brief Get the counters of the parser
+     *
+     * @param stats structure the actual counters are copied to
+     * @return none
+     */
+    void getStats(ussParserStats_t &stats) const;
+
+    private:
+
+    /**
+     * @brief Byte at position offset from the start of the buffer
+     */
+    byte at(const unsigned int offset) const;
+
+    byte m_buffer[USS_PARSER_BUFFER_LENGTH];
+    unsigned int m_head;                  // free running read and write positions, masked on access
+    unsigned int m_tail;
+    ussParserStats_t m_stats;
+};
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSPigpioTransport.cpp
+ *   @brief  class implementation for the USS transport with driver enable pin switched with pigpio, also
+ *           implements USS::begin() with a driver enable pin on top of it
+ *   @date   17.10.2026
+ */
+#include "USSPigpioTransport.h"
+//HINT: Make sure you installed pigpio c Library on raspberry pi before using this lib
+#include <pigpio.h>
+
+USSPigpioTransport::USSPigpioTransport(const int dePin) :
+    USSTermiosTransport(false),
+    m_dePin(dePin)
+{
+}
+
+int USSPigpioTransport::open(const char *sertty, const unsigned int speed)
+{
+    if(USSTermiosTransport::open(sertty, speed) != 0)
+        return -1;
+
+    if(m_dePin >= 0)
+    {
+        gpioSetMode(m_dePin, PI_OUTPUT);
+        gpioWrite(m_dePin, 0);
+    }
+
+    return 0;
+}
+
+int USSPigpioTransport::write(const byte buffer[], const int length)
+{
+    int ret;
+
+    if(m_dePin >= 0)
+        gpioWrite(m_dePin, 1);
+
+    ret = writeDrain(buffer, length);
+
+    if(m_dePin >= 0)
+        gpioWrite(m_dePin, 0);
+
+    return ret;
+}
+
+int USS::begin(const char *sertty, unsigned int speed, const char slaves[], const int nrSlaves, const int dePin)
+{
+    USSPigpioTransport *transport;
+    int ret;
+
+    if(m_transport != nullptr)
+        return -1;
+
+    transport = new USSPigpioTransport(dePin);
+    ret = begin(transport, sertty, speed, slaves, nrSlaves);
+
+    if(ret != 0)
+    {
+        delete transport;
+        return ret;
+    }
+
+    // the transport is created here, so the USS instance deletes it
+    m_ownTransport = true;
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSPigpioTransport.h
+ *   @brief  class definition for the USS transport with the driver enable pin of the RS485 converter (like
+ *           MAX485) on a GPIO of the Raspberry Pi, switched with pigpio. Only this backend needs pigpio, on
+ *           other hosts leave out USSPigpioTransport.cpp and use the backends in USSTransport.h.
+ *   @date   17.10.2026
+ */
+#ifndef USS_PIGPIO_TRANSPORT_H
+#define USS_PIGPIO_TRANSPORT_H
+
+#include "USSTransport.h"
+
+class USSPigpioTransport : public USSTermiosTransport
+{
+    public:
+
+    /**
+     * @brief Constructor for USSPigpioTransport class
+     *
+     * @param dePin GPIO of the driver enable pin, -1 for converters that switch direction on their own
+     */
+    USSPigpioTransport(const int dePin);
+
+    /**
+     * @brief Open the serial device and set the driver enable pin to receive
+     *
+     * @retval 0: success
+     * @retval -1: failure
+     *
+     * The serial device is opened with termios and not with serOpen() of pigpio, because USS needs 8E1
+     * framing (even parity) and pigpio only does 8N1. gpioInitialise() must be called before.
+     */
+    virtual int open(const char *sertty, const unsigned int speed);
+
+    /**
+     * @brief Send a telegram with the driver enabled, it is disabled as soon as the last character left the UART
+     */
+    virtual int write(const byte buffer[], const int length);
+
+    private:
+
+    int m_dePin;
+};
+
+#endif
@@ -0,0 +1,254 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSProtocol.h
+ *   @brief  definitions of the Siemens USS protocol: telegram layout, address byte, PKW and PZD words, control
+ *           and status word flags, and the helpers to read, write and check telegram buffers. Shared by the
+ *           USS class and the parser without pulling in either of them.
+ *   @date   17.10.2026
+ */
+#ifndef USS_PROTOCOL_H
+#define USS_PROTOCOL_H
+
+#include <stdint.h>
+
+/**
+ * @brief STX start byte
+ */
+#define STX_BYTE_STX               0x02
+
+/**
+ * @brief Define for empty parameter value to check if parameter was written on the bus
+ */
+#define PARAM_VALUE_EMPTY          0xA000
+
+/**
+ * @brief Flags in USS address byte (address has only 5 bits)
+ */
+#define ADDR_BYTE_BROADCAST_FLAG   0x20
+#define ADDR_BYTE_MIRROR_FLAG      0x40
+#define ADDR_BYTE_SPECIAL_FLAG     0x80
+
+/**
+ * @brief Bitmasks for PKE field and address byte
+ */
+#define ADDR_BYTE_ADDR_MASK        0x1F
+#define PKE_WORD_PARAM_MASK        0x7FF
+#define PKE_WORD_SP_FLAG           0x800
+#define PKE_WORD_AK_MASK           0xF000
+#define PKE_WORD_AK_NO_TASK        0x0000
+#define PKE_WORD_AK_REQ_PWE        0x1000
+#define PKE_WORD_AK_CHW_PWE        0x2000
+#define PKE_WORD_AK_CHD_PWE        0x3000
+
+/**
+ * @brief Response code for PKE operations
+ */
+#define PKE_WORD_AK_NO_RESP        0x0000
+#define PKE_WORD_AK_TRW_PWE        0x1000
+#define PKE_WORD_AK_TRD_PWE        0x2000
+#define PKE_WORD_AK_NO_RIGHTS      0x8000
+#define PKE_WORD_AK_CANT_EXECUTE   0x7000
+
+/**
+ * @brief Control word flags and descriptions
+ */
+#define CTL_WORD_ON_OFF1_FLAG      0x0001
+#define CTL_WORD_ON_OFF1_OFF1      0x0000
+#define CTL_WORD_ON_OFF1_ON        0x0001
+#define CTL_WORD_OFF2_FLAG         0x0002
+#define CTL_WORD_OFF2_OFF2         0x0000
+#define CTL_WORD_OFF2_OP_COND      0x0002
+#define CTL_WORD_OFF3_FLAG         0x0004
+#define CTL_WORD_OFF3_OFF3         0x0000
+#define CTL_WORD_OFF3_OP_COND      0x0004
+#define CTL_WORD_ENABLE_FLAG       0x0008
+#define CTL_WORD_ENABLE_INHIBIT    0x0000
+#define CTL_WORD_ENABLE_ENABLE     0x0008
+#define CTL_WORD_INHIBIT_RAMP_FLAG       0x0010
+#define CTL_WORD_INHIBIT_RAMP_INHIBIT    0x0000
+#define CTL_WORD_INHIBIT_RAMP_OP_COND    0x0010
+#define CTL_WORD_ENABLE_RAMP_FLAG        0x0020
+#define CTL_WORD_ENABLE_RAMP_HOLD        0x0000
+#define CTL_WORD_ENABLE_RAMP_ENABLE      0x0020
+#define CTL_WORD_ENABLE_SETPOINT_FLAG    0x0040
+#define CTL_WORD_ENABLE_SETPOINT_INHIBIT 0x0000
+#define CTL_WORD_ENABLE_SETPOINT_ENABLE  0x0040
+#define CTL_WORD_ACK_FLAG          0x0080
+#define CTL_WORD_CTL_PLC_FLAG      0x0400
+#define CTL_WORD_CTL_PLC_NO_CTL    0x0000
+#define CTL_WORD_CTL_PLC_CTL_PLC   0x0400
+
+/**
+ * @brief Status word flags and descriptions
+ */
+#define STATUS_WORD_SWITCH_READY_FLAG           0x0001
+#define STATUS_WORD_SWITCH_READY                0x0001
+#define STATUS_WORD_SWITCH_NOT_READY            0x0000
+#define STATUS_WORD_READY_FLAG                  0x0002
+#define STATUS_WORD_READY                       0x0002
+#define STATUS_WORD_NOT_READY                   0x0000
+#define STATUS_WORD_OP_ENABLED_FLAG             0x0004
+#define STATUS_WORD_OP_ENABLED_ENABLED          0x0004
+#define STATUS_WORD_OP_ENABLED_INHIBIT          0x0000
+#define STATUS_WORD_FAULT_FLAG                  0x0008
+#define STATUS_WORD_FAULT_FAULT                 0x0008
+#define STATUS_WORD_FAULT_FAUlT_FREE            0x0000
+#define STATUS_WORD_OFF2_FLAG                   0x0010
+#define STATUS_WORD_OFF2_NO_OFF2                0x0010
+#define STATUS_WORD_OFF2_OFF2                   0x0000
+#define STATUS_WORD_OFF3_FLAG                   0x0020
+#define STATUS_WORD_OFF3_NO_OFF3                0x0020
+#define STATUS_WORD_OFF3_OFF3                   0x0000
+#define STATUS_WORD_SWITCH_INHIBIT_FLAG         0x0040
+#define STATUS_WORD_SWITCH_INHIBIT_INHIBIT      0x0040
+#define STATUS_WORD_SWITCH_INHIBIT_NO_INHIBIT   0x0000
+#define STATUS_WORD_ALARM_FLAG                  0x0080
+#define STATUS_WORD_ALARM_ALARM                 0x0080
+#define STATUS_WORD_ALARM_NO_ALARM              0x0000
+#define STATUS_WORD_SETPOINT_TOL_FLAG           0x0100
+#define STATUS_WORD_SETPOINT_TOL_IN_RANGE       0x0100
+#define STATUS_WORD_SETPOINT_TOL_NOT_IN_RANGE   0x0000
+#define STATUS_WORD_CTL_REQ_FLAG                0x0200
+#define STATUS_WORD_CTL_REQ_CTL_REQ             0x0200
+#define STATUS_WORD_CTL_REQ_LOCAL_OP            0x0000
+#define STATUS_WORD_F_N_REACHED_FLAG            0x0400
+#define STATUS_WORD_F_N_REACHED_REACHED         0x0400
+#define STATUS_WORD_F_N_REACHED_FALLEN_BELOW    0x0000
+
+/**
+ * @brief Max number of USS Slaves, default is the full 5 bit address space, can be set at compile time
+ *        (-DUSS_SLAVES=...) to save memory
+ */
+#ifndef USS_SLAVES
+#define USS_SLAVES                 (ADDR_BYTE_ADDR_MASK + 1)
+#endif
+
+/**
+ * @brief number of PKW and PZD words in the telegram, can be set at compile time (-DUSS_PKW_WORDS=...).
+ *        PKW words must be 0 (no parameter channel), 3 or 4 and PZD words 2 to 8, both must match the
+ *        settings of the slaves.
+ */
+#ifndef USS_PKW_WORDS
+#define USS_PKW_WORDS              4
+#endif
+#ifndef USS_PZD_WORDS
+#define USS_PZD_WORDS              2
+#endif
+
+/**
+ * @brief length of PZD and PKW fields in bytes
+ */
+#define PZD_LENGTH_CHARACTERS      (USS_PZD_WORDS * 2)
+#define PKW_LENGTH_CHARACTERS      (USS_PKW_WORDS * 2)
+
+/**
+ * @brief number of additional PZD words after control/status word and main setpoint/actual value, PZD3 to PZDn
+ */
+#define USS_PZD_ADD_WORDS          (USS_PZD_WORDS - 2)
+
+/**
+ * @brief USS parameters
+ */
+#define CHARACTER_RUNTIME_BASE_US  1150
+#define BAUDRATE_BASE              9600
+#define MAX_RESP_DELAY_TIME_MS     20
+#define MASTER_COMPUTE_DELAY_MS    20
+#define START_DELAY_LENGTH_CHARACTERS 2
+#define TELEGRAM_OVERHEAD_CHARACTERS 4
+
+#define USS_BUFFER_LENGTH               (TELEGRAM_OVERHEAD_CHARACTERS + PKW_LENGTH_CHARACTERS + PZD_LENGTH_CHARACTERS)
+#define USS_MAX_TELEGRAM_LENGTH         256     // LGE is at most 254
+
+/**
+ * @brief Offsets of the fields in the telegram: STX, LGE, ADR, PKW words, PZD words, BCC
+ */
+constexpr int USS_LGE_OFFSET = 1;
+constexpr int USS_ADR_OFFSET = 2;
+constexpr int USS_PKW_OFFSET = 3;
+constexpr int USS_PKE_OFFSET = USS_PKW_OFFSET;
+constexpr int USS_IND_OFFSET = USS_PKW_OFFSET + 2;
+constexpr int USS_PWE_OFFSET = USS_PKW_OFFSET + 4;                         // PWE1, high word of double words
+constexpr int USS_PZD_OFFSET = USS_PKW_OFFSET + PKW_LENGTH_CHARACTERS;
+constexpr int USS_PZD_ADD_OFFSET = USS_PZD_OFFSET + 4;                     // PZD3, first additional word
+constexpr int USS_BCC_OFFSET = USS_PZD_OFFSET + PZD_LENGTH_CHARACTERS;
+constexpr int USS_LGE_VALUE = USS_BUFFER_LENGTH - 2;                       // LGE counts ADR to BCC
+
+static_assert(USS_PKW_WORDS == 0 || USS_PKW_WORDS == 3 || USS_PKW_WORDS == 4, "USS_PKW_WORDS must be 0, 3 or 4");
+static_assert(USS_PZD_WORDS >= 2 && USS_PZD_WORDS <= 8, "USS_PZD_WORDS must be 2 to 8");
+static_assert(USS_SLAVES >= 1 && USS_SLAVES <= ADDR_BYTE_ADDR_MASK + 1, "USS_SLAVES must be 1 to 32");
+
+// custom data types
+typedef unsigned char byte;
+typedef unsigned char uint8_t;
+typedef unsigned short uint16_t;
+typedef unsigned int uint32_t ;
+
+/**
+ * @brief Write a word to a telegram buffer, high byte first like in USS spec.
+ */
+inline void ussPutWord(byte buffer[], const int offset, const uint16_t value)
+{
+    buffer[offset] = (value >> 8) & 0xFF;
+    buffer[offset + 1] = value & 0xFF;
+}
+
+/**
+ * @brief Read a word from a telegram buffer, high byte first like in USS spec.
+ */
+inline uint16_t ussGetWord(const byte buffer[], const int offset)
+{
+    return ((buffer[offset] << 8) & 0xFF00) | (buffer[offset + 1] & 0xFF);
+}
+
+/**
+ * @brief Calculates the Block Check Character (BCC) like in USS spec.
+ *
+ * @param buffer data over which the BCC is calculated
+ * @param length length in bytes over which the BCC is calculated
+ * @return the BCC value
+ */
+inline byte ussBCC(const byte buffer[], const int length)
+{
+    byte ret = 0;
+
+    for(int i = 0; i < length; i++)
+        ret = ret ^ buffer[i];
+
+    return ret;
+}
+
+/**
+ * @brief Write a word to a complete telegram and update its BCC with the changed bits only, XOR of the old and
+ *        new bytes takes the old ones out of the BCC and adds the new ones.
+ */
+inline void ussPatchWord(byte telegram[], const int offset, const uint16_t value)
+{
+    const byte high = (value >> 8) & 0xFF;
+    const byte low = value & 0xFF;
+
+    telegram[USS_BCC_OFFSET] ^= telegram[offset] ^ high ^ telegram[offset + 1] ^ low;
+    telegram[offset] = high;
+    telegram[offset + 1] = low;
+}
+
+#endif
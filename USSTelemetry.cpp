@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSTelemetry.cpp
+ *   @brief  class implementation for recording the process data of every telegram into a memory mapped binary log
+ *   @date   17.10.2026
+ */
+#include "USSTelemetry.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+
+USSTelemetry::USSTelemetry() :
+    m_ring(),
+    m_head(0),
+    m_tail(0),
+    m_dropped(0),
+    m_fd(-1),
+    m_header(nullptr),
+    m_records(nullptr),
+    m_size(0),
+    m_run(false),
+    m_thread()
+{
+}
+
+USSTelemetry::~USSTelemetry()
+{
+    close();
+}
+
+int USSTelemetry::open(const char *path, const unsigned long capacity)
+{
+    void *map;
+
+    if(path == nullptr || capacity == 0 || m_fd >= 0)
+        return -1;
+
+    m_size = sizeof(ussTelemetryHeader_t) + capacity * sizeof(ussTelemetrySample_t);
+    m_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if(m_fd < 0)
+        return -1;
+
+    if(ftruncate(m_fd, m_size) != 0)
+    {
+        close();
+        return -1;
+    }
+
+    map = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+
+    if(map == MAP_FAILED)
+    {
+        close();
+        return -1;
+    }
+
+    m_header = static_cast<ussTelemetryHeader_t *>(map);
+    m_records = reinterpret_cast<ussTelemetrySample_t *>(m_header + 1);
+    m_header->magic = USS_TELEMETRY_MAGIC;
+    m_header->version = USS_TELEMETRY_VERSION;
+    m_header->recordSize = sizeof(ussTelemetrySample_t);
+    m_header->capacity = capacity;
+    m_header->count = 0;
+    m_header->dropped = 0;
+
+    m_head.store(0);
+    m_tail.store(0);
+    m_dropped.store(0);
+    m_run.store(true);
+
+    if(pthread_create(&m_thread, nullptr, writerThread, this) != 0)
+    {
+        m_run.store(false);
+        close();
+        return -1;
+    }
+
+    return 0;
+}
+
+void USSTelemetry::close()
+{
+    if(m_run.load())
+    {
+        m_run.store(false);
+        pthread_join(m_thread, nullptr);
+    }
+
+    if(m_header != nullptr)
+    {
+        drain();
+        msync(m_header, m_size, MS_SYNC);
+        munmap(m_header, m_size);
+    }
+
+    if(m_fd >= 0)
+        ::close(m_fd);
+
+    m_header = nullptr;
+    m_records = nullptr;
+    m_fd = -1;
+}
+
+unsigned long USSTelemetry::written() const
+{
+    return m_header != nullptr ? m_header->count : 0;
+}
+
+unsigned long USSTelemetry::dropped() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+void *USSTelemetry::writerThread(void *arg)
+{
+    USSTelemetry *telemetry = static_cast<USSTelemetry *>(arg);
+    const struct timespec interval = {0, USS_TELEMETRY_WRITE_MS * NSEC_PER_MSEC};
+
+    while(telemetry->m_run.load(std::memory_order_relaxed))
+    {
+        telemetry->drain();
+        nanosleep(&interval, nullptr);
+    }
+
+    return nullptr;
+}
+
+void USSTelemetry::drain()
+{
+    const uint64_t head = m_head.load(std::memory_order_acquire);
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    uint64_t count = m_header->count;
+
+    for(; tail != head; tail++, count++)
+        m_records[count % m_header->capacity] = m_ring[tail & (USS_TELEMETRY_RING_LENGTH - 1)];
+
+    // the slots are given back to the bus thread after the copy, the count after the records, so a reader of
+    // the file never sees a record counted before it is written
+    m_tail.store(tail, std::memory_order_release);
+    m_header->dropped = m_dropped.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->count = count;
+}
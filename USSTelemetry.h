@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSTelemetry.h
+ *   @brief  class definition for recording the process data of every telegram into a memory mapped binary log.
+ *           The bus thread pushes one sample per telegram into a lock-free ring, a writer thread copies them to
+ *           the file, which keeps the last samples like a flight recorder. Telemetry/uss_telemetry_csv exports
+ *           the log to CSV.
+ *   @date   17.10.2026
+ */
+#ifndef USS_TELEMETRY_H
+#define USS_TELEMETRY_H
+
+#include "USS.h"
+
+/**
+ * @brief Number of samples in the ring between bus thread and writer thread, power of 2
+ */
+#ifndef USS_TELEMETRY_RING_LENGTH
+#define USS_TELEMETRY_RING_LENGTH  4096
+#endif
+
+/**
+ * @brief Identification and version of the log file
+ */
+#define USS_TELEMETRY_MAGIC        0x4D4C5455      // "UTLM"
+#define USS_TELEMETRY_VERSION      1
+
+/**
+ * @brief Interval of the writer thread in ms
+ */
+#define USS_TELEMETRY_WRITE_MS     10
+
+static_assert((USS_TELEMETRY_RING_LENGTH & (USS_TELEMETRY_RING_LENGTH - 1)) == 0, "USS_TELEMETRY_RING_LENGTH must be a power of 2");
+
+/**
+ * @struct structure definition for the sample of one telegram, also the record in the log file
+ */
+typedef struct
+{
+    uint64_t timeNs;                // end of the response on CLOCK_MONOTONIC
+    uint32_t cycle;                 // number of the telegram since begin()
+    uint8_t slave;                  // slave index
+    uint8_t valid;                  // 1 for a valid response, 0 keeps the inputs of the last valid one
+    uint16_t statusword;
+    uint16_t mainactualvalue;
+    uint16_t ctlword;               // outputs sent in the telegram
+    uint16_t mainsetpoint;
+    uint16_t reserved;
+} ussTelemetrySample_t;
+
+static_assert(sizeof(ussTelemetrySample_t) == 24, "record of the log file must be 24 bytes");
+
+/**
+ * @struct structure definition for the header of the log file, the records follow it
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint64_t capacity;              // number of records in the file
+    uint64_t count;                 // records written since the start, record n is at n % capacity
+    uint64_t dropped;               // samples lost because the ring was full
+} ussTelemetryHeader_t;
+
+class USSTelemetry
+{
+    public:
+
+    /**
+     * @brief Constructor for USSTelemetry class, initializes the members
+     *
+     * @return none
+     */
+    USSTelemetry();
+
+    /**
+     * @brief Destructor for USSTelemetry class, closes the log file
+     */
+    ~USSTelemetry();
+
+    /**
+     * @brief Create the log file and start the writer thread
+     *
+     * @param path path of the log file, an existing file is overwritten
+     * @param capacity number of records in the file, when it is full the oldest records are overwritten
+     * @retval 0: success
+     * @retval -1: failure
+     *
+     * The file gets its full size at once and is mapped, so writing never extends it.
+     */
+    int open(const char *path, const unsigned long capacity);
+
+    /**
+     * @brief Stop the writer thread, write the rest of the ring and close the log file
+     *
+     * @return none
+     */
+    void close();
+
+    /**
+     * @brief Add a sample to the ring, called by the bus thread only
+     *
+     * @param sample sample of one telegram
+     * @return none
+     *
+     * Only stores into the ring and one release store of the write position, a full ring drops the sample and
+     * counts it instead of waiting for the writer.
+     */
+    inline void push(const ussTelemetrySample_t &sample)
+    {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+
+        if(head - m_tail.load(std::memory_order_acquire) == USS_TELEMETRY_RING_LENGTH)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        m_ring[head & (USS_TELEMETRY_RING_LENGTH - 1)] = sample;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get number of records written to the file
+     *
+     * @return records written since open()
+     */
+    unsigned long written() const;
+
+    /**
+     * @brief Get number of samples lost because the ring was full
+     *
+     * @return samples dropped since open()
+     */
+    unsigned long dropped() const;
+
+    private:
+
+    /**
+     * @brief Thread function of the writer thread
+     *
+     * @param arg pointer to the USSTelemetry instance
+     * @return nullptr
+     */
+    static void *writerThread(void *arg);
+
+    /**
+     * @brief Copy all samples in the ring to the file
+     */
+    void drain();
+
+    ussTelemetrySample_t m_ring[USS_TELEMETRY_RING_LENGTH];
+    alignas(64) std::atomic<uint64_t> m_head;     // written by the bus thread
+    alignas(64) std::atomic<uint64_t> m_tail;     // written by the writer thread
+    std::atomic<uint64_t> m_dropped;
+    int m_fd;
+    ussTelemetryHeader_t *m_header;               // start of the mapped file
+    ussTelemetrySample_t *m_records;
+    size_t m_size;
+    std::atomic<bool> m_run;
+    pthread_t m_thread;
+};
+
+#endif
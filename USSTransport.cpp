@@ -0,0 +1,230 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSTransport.cpp
+ *   @brief  class implementation of the termios and kernel RS485 transports for the USS telegrams
+ *   @date   17.10.2026
+ */
+#include "USSTransport.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <linux/serial.h>
+
+/**
+ * @brief Map a baudrate to the termios speed constant, B0 for baudrates not supported by USS
+ */
+static speed_t baudrateToSpeed(const unsigned int speed)
+{
+    switch(speed)
+    {
+        case 1200:   return B1200;
+        case 2400:   return B2400;
+        case 4800:   return B4800;
+        case 9600:   return B9600;
+        case 19200:  return B19200;
+        case 38400:  return B38400;
+        case 57600:  return B57600;
+        case 115200: return B115200;
+        default:     return B0;
+    }
+}
+
+USSTermiosTransport::USSTermiosTransport(const bool rtsDriverEnable) :
+    m_fd(-1),
+    m_rtsDriverEnable(rtsDriverEnable)
+{
+}
+
+USSTermiosTransport::~USSTermiosTransport()
+{
+    close();
+}
+
+int USSTermiosTransport::open(const char *sertty, const unsigned int speed)
+{
+    struct termios tty;
+    speed_t ttySpeed = baudrateToSpeed(speed);
+    int rts = TIOCM_RTS;
+
+    if(sertty == nullptr || ttySpeed == B0 || m_fd >= 0)
+        return -1;
+
+    // opened non blocking, the response is waited for with poll() and a deadline
+    m_fd = ::open(sertty, O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+    if(m_fd < 0)
+        return -1;
+
+    if(tcgetattr(m_fd, &tty) != 0)
+    {
+        close();
+        return -1;
+    }
+
+    // USS uses 8 data bits, even parity and 1 stop bit
+    cfmakeraw(&tty);
+    tty.c_cflag &= ~(CSIZE | PARODD | CSTOPB | CRTSCTS);
+    tty.c_cflag |= CS8 | PARENB | CLOCAL | CREAD;
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    cfsetispeed(&tty, ttySpeed);
+    cfsetospeed(&tty, ttySpeed);
+
+    if(tcsetattr(m_fd, TCSANOW, &tty) != 0)
+    {
+        close();
+        return -1;
+    }
+
+    if(m_rtsDriverEnable)
+        ioctl(m_fd, TIOCMBIC, &rts);
+
+    tcflush(m_fd, TCIOFLUSH);
+
+    return 0;
+}
+
+void USSTermiosTransport::close()
+{
+    if(m_fd >= 0)
+        ::close(m_fd);
+
+    m_fd = -1;
+}
+
+int USSTermiosTransport::write(const byte buffer[], const int length)
+{
+    int rts = TIOCM_RTS;
+    int ret;
+
+    if(m_rtsDriverEnable)
+        ioctl(m_fd, TIOCMBIS, &rts);
+
+    ret = writeDrain(buffer, length);
+
+    if(m_rtsDriverEnable)
+        ioctl(m_fd, TIOCMBIC, &rts);
+
+    return ret;
+}
+
+int USSTermiosTransport::writeDrain(const byte buffer[], const int length)
+{
+    for(int written = 0, ret; written < length; written += ret)
+    {
+        ret = ::write(m_fd, buffer + written, length - written);
+
+        if(ret < 0 && errno == EAGAIN)
+        {
+            struct pollfd pfd = {m_fd, POLLOUT, 0};
+
+            poll(&pfd, 1, -1);
+            ret = 0;
+        }
+        else if(ret < 0 && errno != EINTR)
+        {
+            return -1;
+        }
+        else if(ret < 0)
+        {
+            ret = 0;
+        }
+    }
+
+    // returns when the transmit shift register is empty, not only the buffer of the driver, so the bus can be
+    // switched to receive at once without clipping the last character. USB adapters report the bytes as sent
+    // when they reached the adapter, their driver enable has to be switched by the adapter itself
+    while(tcdrain(m_fd) != 0)
+    {
+        if(errno != EINTR)
+            return -1;
+    }
+
+    return 0;
+}
+
+int USSTermiosTransport::read(byte buffer[], const int length, const struct timespec &deadline)
+{
+    struct pollfd pfd = {m_fd, POLLIN, 0};
+    struct timespec now;
+    struct timespec timeout;
+
+    while(true)
+    {
+        int len = ::read(m_fd, buffer, length);
+
+        if(len > 0)
+            return len;
+
+        if(len < 0 && errno != EAGAIN && errno != EINTR)
+            return -1;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        if(ussTimespecDiffNs(deadline, now) <= 0)
+            return 0;
+
+        timeout.tv_sec = 0;
+        timeout.tv_nsec = 0;
+        ussTimespecAddNs(timeout, ussTimespecDiffNs(deadline, now));
+
+        ppoll(&pfd, 1, &timeout, nullptr);
+    }
+}
+
+USSRS485Transport::USSRS485Transport(const bool rtsOnSend) :
+    USSTermiosTransport(false),
+    m_rtsOnSend(rtsOnSend)
+{
+}
+
+int USSRS485Transport::open(const char *sertty, const unsigned int speed)
+{
+    struct serial_rs485 rs485;
+
+    if(USSTermiosTransport::open(sertty, speed) != 0)
+        return -1;
+
+    memset(&rs485, 0, sizeof(rs485));
+    rs485.flags = SER_RS485_ENABLED | (m_rtsOnSend ? SER_RS485_RTS_ON_SEND : SER_RS485_RTS_AFTER_SEND);
+    rs485.delay_rts_before_send = 0;
+    rs485.delay_rts_after_send = 0;
+
+    if(ioctl(m_fd, TIOCSRS485, &rs485) != 0)
+    {
+        close();
+        return -1;
+    }
+
+    return 0;
+}
+
+int USSRS485Transport::write(const byte buffer[], const int length)
+{
+    // the driver switches RTS back when the transmission is complete, tcdrain() only makes the end of the
+    // telegram the start of the response time
+    return writeDrain(buffer, length);
+}
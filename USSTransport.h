@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2026, RPI_SINAMICS_G110 contributors
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+/**
+ * @section LICENSE
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3 or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ *   @file   USSTransport.h
+ *   @brief  class definitions for the serial transport of the USS telegrams. USSTransport is the interface
+ *           used by the USS class, the backends open the serial device with 8E1 framing like USS needs and
+ *           switch the RS485 bus from sending to receiving when the last character left the UART:
+ *           USSTermiosTransport waits with tcdrain() and can use RTS as driver enable, USSRS485Transport
+ *           lets the kernel switch RTS (TIOCSRS485). The pigpio backend is in USSPigpioTransport.h.
+ *           On USB-RS485 adapters tcdrain() returns once the bytes reached the adapter, not the wire, the
+ *           adapter switches its driver itself.
+ *   @date   17.10.2026
+ */
+#ifndef USS_TRANSPORT_H
+#define USS_TRANSPORT_H
+
+#include "USS.h"
+
+class USSTransport
+{
+    public:
+
+    virtual ~USSTransport() {}
+
+    /**
+     * @brief Open and configure the serial device
+     *
+     * @param sertty the serial device to open ex: "/dev/ttyS0" ,"/dev/serial0" . "/dev/ttyUSB0"
+     * @param speed Baudrate of the serial device
+     * @retval 0: success
+     * @retval -1: failure
+     */
+    virtual int open(const char *sertty, const unsigned int speed) = 0;
+
+    /**
+     * @brief Close the serial device
+     *
+     * @return none
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief Send a telegram, returns when the last character is on the wire and the bus is switched to receive
+     *
+     * @param buffer telegram to send
+     * @param length length of the telegram in bytes
+     * @retval 0: success
+     * @retval -1: write to the serial device failed
+     */
+    virtual int write(const byte buffer[], const int length) = 0;
+
+    /**
+     * @brief Receive the bytes available, waits until at least one byte is there or the deadline is over
+     *
+     * @param buffer buffer for the received bytes
+     * @param length max number of bytes to receive
+     * @param deadline absolute time on CLOCK_MONOTONIC to wait until
+     * @return number of bytes received, 0 when the deadline is over, -1 on error of the serial device
+     *
+     * Returns as soon as bytes arrived, so the caller can parse the telegram while it is still received and
+     * stop waiting when it is complete, whatever its length is.
+     */
+    virtual int read(byte buffer[], const int length, const struct timespec &deadline) = 0;
+};
+
+class USSTermiosTransport : public USSTransport
+{
+    public:
+
+    /**
+     * @brief Constructor for USSTermiosTransport class
+     *
+     * @param rtsDriverEnable set RTS while sending, for RS485 converters with the driver enable pin on RTS, false
+     *                        for converters that switch direction on their own (like most RS485/USB modules)
+     */
+    USSTermiosTransport(const bool rtsDriverEnable = false);
+
+    /**
+     * @brief Destructor for USSTermiosTransport class, closes the serial device
+     */
+    virtual ~USSTermiosTransport();
+
+    virtual int open(const char *sertty, const unsigned int speed);
+    virtual void close();
+    virtual int write(const byte buffer[], const int length);
+    virtual int read(byte buffer[], const int length, const struct timespec &deadline);
+
+    protected:
+
+    /**
+     * @brief Write all bytes to the serial device and wait with tcdrain() until the last one left the UART,
+     *        on USB serial adapters only until the bytes reached the adapter
+     *
+     * @retval 0: success
+     * @retval -1: failure
+     */
+    int writeDrain(const byte buffer[], const int length);
+
+    int m_fd;                             // file descriptor of the serial device
+    bool m_rtsDriverEnable;
+};
+
+class USSRS485Transport : public USSTermiosTransport
+{
+    public:
+
+    /**
+     * @brief Constructor for USSRS485Transport class
+     *
+     * @param rtsOnSend logical level of RTS while sending, true for converters with active high driver enable
+     */
+    USSRS485Transport(const bool rtsOnSend = true);
+
+    /**
+     * @brief Open the serial device and switch on the RS485 mode of the kernel driver
+     *
+     * @retval 0: success
+     * @retval -1: failure, also when the driver doesn't support RS485 mode
+     *
+     * The driver switches RTS at the exact start and end of the transmission, the receiver is disabled while
+     * sending, so the own telegram is never read back.
+     */
+    virtual int open(const char *sertty, const unsigned int speed);
+
+    /**
+     * @brief Send a telegram, the driver switches RTS
+     */
+    virtual int write(const byte buffer[], const int length);
+
+    private:
+
+    bool m_rtsOnSend;
+};
+
+#endif